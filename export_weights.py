@@ -0,0 +1,68 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+"""
+Export the weights of the policy network (tfgo.py) for the native inference in
+go_engine/src/policy_net.h and optionally reference outputs of TensorFlow.
+
+usage: python export_weights.py --load train_log/tfgo-policy_net-128/checkpoint --out tfgo.bin
+       python export_weights.py --load ... --out tfgo.bin --export export --reference ref.bin
+"""
+
+import argparse
+import struct
+import numpy as np
+import tensorflow as tf
+
+LAYERS = ['conv%i' % i for i in range(1, 13)] + ['conv_final']
+
+
+def export_weights(checkpoint, out):
+    reader = tf.train.NewCheckpointReader(checkpoint)
+    with open(out, 'wb') as f:
+        f.write(b'TFGO')
+        f.write(struct.pack('<ii', 1, len(LAYERS)))
+        for name in LAYERS:
+            w = reader.get_tensor(name + '/W').astype('<f4')  # HWIO
+            has_bias = reader.has_tensor(name + '/b')
+            relu = name != 'conv_final'
+            f.write(struct.pack('<iiiii', w.shape[0], w.shape[2], w.shape[3], int(has_bias), int(relu)))
+            f.write(w.tobytes())
+            if has_bias:
+                f.write(reader.get_tensor(name + '/b').astype('<f4').tobytes())
+            print '%s: %s%s' % (name, w.shape, ' + bias' if has_bias else '')
+
+
+def export_reference(export_dir, planes, out, batch=4):
+    """Random binary planes and the probabilities of the exported graph.
+
+    Layout: int32 batch, int32 planes, float32 input[batch][planes][19][19],
+            float32 probabilities[batch][19][19]
+    """
+    from tensorflow.python.saved_model import tag_constants
+    sess = tf.Session(graph=tf.Graph())
+    tf.saved_model.loader.load(sess, [tag_constants.SERVING], export_dir)
+    features = sess.graph.get_tensor_by_name('board_plhdr:0')
+    prob = sess.graph.get_tensor_by_name('probabilities:0')
+
+    rng = np.random.RandomState(42)
+    x = (rng.rand(batch, planes, 19, 19) < 0.3).astype(np.float32)
+    p = sess.run(prob, {features: x})
+    with open(out, 'wb') as f:
+        f.write(struct.pack('<ii', batch, planes))
+        f.write(x.astype('<f4').tobytes())
+        f.write(p.astype('<f4').tobytes())
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--load', help='path to checkpoint of model', required=True)
+    parser.add_argument('--out', help='binary weights file', required=True)
+    parser.add_argument('--export', help='directory of export_model.py (for --reference)')
+    parser.add_argument('--reference', help='write reference inputs and outputs to this file')
+    args = parser.parse_args()
+
+    export_weights(args.load, args.out)
+    if args.reference:
+        planes = tf.train.NewCheckpointReader(args.load).get_tensor('conv1/W').shape[2]
+        export_reference(args.export, planes, args.reference)
@@ -13,6 +13,10 @@ from tensorpack.utils import get_rng
 import multiprocessing
 
 FEATURE_LEN = 49
+# alternative feature set: last 8 positions per colour + colour plane (AlphaGo Zero)
+HISTORY_FEATURE_LEN = 17
+# feature planes + liberties after move (8 planes)
+EXTENDED_FEATURE_LEN = 57
 
 
 class GoGamesFromDir(tp.dataflow.DataFlow):
@@ -37,18 +41,21 @@ class GameDecoder(MapData):
 
     bytes ---> [features, next_move]
     """
-    def __init__(self, df, random_move=True, until=None, verbose=False):
+    def __init__(self, df, random_move=True, until=None, verbose=False, history=False, extended=False):
         """Yield a board configuration and next move from a LMDB data point
 
         Args:
             df: dataflow of LMDB entries
             random_move (bool, optional): pick random_move move in match
+            history (bool, optional): use the history planes (AlphaGo Zero) as features
+            extended (bool, optional): append the "liberties after move" planes
         """
         rng = get_rng(self)
 
         def func(dp):
             raw = dp[0]
-            max_moves = len(raw) / 2
+            # version 2 files might have a header and compressed moves
+            max_moves = goplanes.num_actions_from_bytes(raw.tobytes())
 
             # game is too short -> skip
             if max_moves < 10:
@@ -65,8 +72,15 @@ class GameDecoder(MapData):
             if verbose:
                 print move_id, np.array(raw).astype(np.uint8)
 
-            features = np.zeros((FEATURE_LEN, 19, 19), dtype=np.int32)
-            next_move = goplanes.planes_from_bytes(raw.tobytes(), features, move_id)
+            if history:
+                features = np.zeros((HISTORY_FEATURE_LEN, 19, 19), dtype=np.int32)
+                next_move = goplanes.history_planes_from_bytes(raw.tobytes(), features, move_id)
+            elif extended:
+                features = np.zeros((EXTENDED_FEATURE_LEN, 19, 19), dtype=np.int32)
+                next_move = goplanes.extended_planes_from_bytes(raw.tobytes(), features, move_id)
+            else:
+                features = np.zeros((FEATURE_LEN, 19, 19), dtype=np.int32)
+                next_move = goplanes.planes_from_bytes(raw.tobytes(), features, move_id)
 
             assert not np.isnan(features).any()
 
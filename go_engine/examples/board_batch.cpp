@@ -0,0 +1,65 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../src/sgfbin.h"
+#include "../src/replay.h"
+#include "../src/board_batch.h"
+
+// lockstep replay of many games against play_game, with and without ladder planes (44, 45)
+
+void test_case001(bool ladders) {
+    const char *files[] = {"../../data/game.sgfbin",
+                           "../../data/ladder_capture.sgfbin",
+                           "../../data/2p0y-gokifu-20170527-Ke_Jie-AlphaGo.sgfbin"};
+    const int num_games = 256;
+    const int area = 19 * 19;
+
+    std::mt19937 rng(42);
+    std::vector<SGFbin*> games;
+    std::vector<int> moves;
+    for (int i = 0; i < num_games; ++i) {
+        games.push_back(new SGFbin(files[i % 3]));
+        moves.push_back(1 + rng() % games.back()->num_actions());
+    }
+
+    std::vector<int> planes(num_games * 49 * area);
+    std::vector<int> next_moves(num_games);
+    auto start = std::chrono::steady_clock::now();
+    play_games(games.data(), num_games, moves.data(), planes.data(), next_moves.data(), ladders);
+    const double secs_batch = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int failed = 0;
+    double secs_single = 0;
+    for (int i = 0; i < num_games; ++i) {
+        SGFbin game(files[i % 3]);
+        std::vector<int> reference(49 * area, 0);
+        start = std::chrono::steady_clock::now();
+        const int next_move = play_game(&game, reference.data(), moves[i]);
+        secs_single += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        bool same = (next_move == next_moves[i]);
+        for (int k = 0; k < 49 * area; ++k) {
+            const int plane = k / area;
+            if (ladders || (plane != 44 && plane != 45))
+                same &= (reference[k] == planes[i * 49 * area + k]);
+            else
+                same &= (planes[i * 49 * area + k] == 0);
+        }
+        failed += !same;
+    }
+    std::cout << (ladders ? "with" : "without") << " ladders: compared " << num_games
+              << " positions, failed " << failed << " vs. 0" << std::endl;
+    std::cout << num_games / secs_batch << " positions/s (batch) vs. " << num_games / secs_single
+              << " positions/s (play_game incl. ladders)" << std::endl;
+
+    for (auto &&g : games)
+        delete g;
+}
+
+int main(int argc, char const *argv[]) {
+    test_case001(true);
+    test_case001(false);
+    return 0;
+}
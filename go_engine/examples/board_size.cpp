@@ -0,0 +1,74 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "board_t.h"
+
+// the same board code for 9x9, 13x13 and 19x19
+
+template<int N>
+int test_capture() {
+    basic_board_t<N> b;
+    int failed = 0;
+
+    // white stone in the corner is captured by two black stones
+    b.play({0, 0}, white);
+    b.play({0, 1}, black);
+    b.play({1, 0}, black);
+    failed += (b.field({0, 0})->token() != empty);
+
+    // the liberties of a stone at the opposite edge are bounded by N
+    b.play({N - 1, N / 2}, white);
+    failed += (b.liberties(N - 1, N / 2) != 3);
+
+    // playing into the captured corner is legal, but it is not a capture anymore
+    std::vector<int> planes(49 * N * N, 0);
+    b.feature_planes(planes.data(), white);
+    int ones = 0;
+    for (int i = 0; i < N * N; ++i)
+        ones += planes[map3line(3, 0, 0) + i];
+    failed += (ones != N * N);
+    failed += (planes[map3line(1, 0, 1)] != 1);
+
+    if (N == 9)
+        std::cout << b << std::endl;
+    return failed;
+}
+
+template<int N>
+void benchmark(int games) {
+    std::mt19937 rng(42);
+    int moves = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int g = 0; g < games; ++g) {
+        basic_board_t<N> b;
+        token_t tok = black;
+        // random moves (no passes) until the board is half full
+        for (int tries = 0; tries < 4 * N * N && b.moves_counter < N * N / 2; ++tries) {
+            const coord_t pos(rng() % N, rng() % N);
+            if (b.is_legal(pos, tok)) {
+                b.play(pos, tok);
+                tok = b.opponent(tok);
+                moves++;
+            }
+        }
+        std::vector<int> planes(49 * N * N, 0);
+        b.feature_planes(planes.data(), tok);
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << N << "x" << N << ": " << games / secs << " games/s, "
+              << moves / secs << " moves/s (including legality tests and feature planes)" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+    const int failed = test_capture<9>() + test_capture<13>() + test_capture<19>();
+    std::cout << "failed " << failed << " vs. 0" << std::endl;
+
+    benchmark<9>(200);
+    benchmark<13>(50);
+    benchmark<19>(10);
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "eval_broker.h"
+
+// batching of concurrent evaluations and throughput for batch sizes 1 and 16
+
+// every client thread evaluates its inputs one after another
+int clients(eval_broker_t &broker, int threads, int requests, int input_size) {
+    std::atomic<int> wrong(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.push_back(std::thread([&, t]() {
+            for (int r = 0; r < requests; ++r) {
+                std::vector<float> input(input_size, 0.f);
+                input[0] = t;
+                input[1] = r;
+                std::vector<float> output = broker.submit(input).get();
+                wrong += (output.size() != 2 || output[0] != t + r || output[1] != t + r + 1);
+            }
+        }));
+    for (auto &&w : workers)
+        w.join();
+    return wrong;
+}
+
+int test_case001() {
+    // futures from several threads, batches never exceed max_batch
+    mock_backend_t backend(47 * 19 * 19, 2, 200);
+    int failed = 0;
+    {
+        eval_broker_t broker(&backend, 8, 5000);
+        failed += clients(broker, 8, 100, 47 * 19 * 19);
+        failed += (broker.requests() != 800);
+        failed += (broker.mean_batch_size() <= 1.f);
+        std::cout << "test_case001 mean batch size " << broker.mean_batch_size() << std::endl;
+    }
+    for (int n : backend.batch_sizes())
+        failed += (n < 1 || n > 8);
+    std::cout << "test_case001 failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int test_case002() {
+    // callbacks, a lone request waits at most max_wait and the destructor flushes the queue
+    mock_backend_t backend(4, 3);
+    std::atomic<int> completed(0), wrong(0);
+    int failed = 0;
+    {
+        eval_broker_t broker(&backend, 64, 20000);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<float> single = broker.submit({1, 2, 3, 4}).get();
+        const double waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        failed += (single.size() != 3 || single[2] != 12.f);
+        failed += (waited < 0.015 || waited > 1.0);
+
+        for (int i = 0; i < 100; ++i)
+            broker.submit({(float) i, 0, 0, 0}, [&, i](std::vector<float> output) {
+                wrong += (output[0] != i);
+                completed++;
+            });
+
+        // wrong input size
+        failed += !broker.submit({1, 2}).get().empty();
+        failed += broker.submit({1, 2}, [](std::vector<float>) {});
+    }
+    failed += (completed != 100) + (wrong != 0);
+    std::cout << "test_case002 failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+void benchmark(int max_batch) {
+    // an accelerator which needs 1ms per call regardless of the batch size
+    mock_backend_t backend(47 * 19 * 19, 19 * 19, 1000);
+    eval_broker_t broker(&backend, max_batch, 2000);
+    auto start = std::chrono::steady_clock::now();
+    clients(broker, 32, 50, 47 * 19 * 19);
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "max batch " << max_batch << ": " << broker.requests() / secs << " evaluations/s, "
+              << broker.mean_batch_size() << " per batch" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+    int failed = test_case001() + test_case002();
+    std::cout << "failed " << failed << " vs. 0" << std::endl;
+
+    benchmark(1);
+    benchmark(16);
+    return 0;
+}
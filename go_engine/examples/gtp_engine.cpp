@@ -0,0 +1,164 @@
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "misc.h"
+#include "token_t.h"
+#include "board_t.h"
+#include "playout.h"
+#include "game.h"
+#include "gtp_engine.h"
+
+// GTP commands, legal masks against board_t::is_legal, undo and genmove latency
+
+int test_case001() {
+    // a short session with ids, errors and a capture which is taken back
+    gtp_engine_t engine;
+    const char *session[][2] = {
+        {"1 protocol_version", "=1 2\n\n"},
+        {"boardsize 9", "=\n\n"},
+        {"boardsize 7", "? unacceptable size\n\n"},
+        {"komi 6.5", "=\n\n"},
+        {"play b A8", "=\n\n"},
+        {"play w A9", "=\n\n"},
+        {"play b B9  # captures A9", "=\n\n"},
+        {"play w A9", "? illegal move\n\n"},
+        {"play x A1", "? syntax error\n\n"},
+        {"play b J9", "=\n\n"},
+        {"play b I9", "? syntax error\n\n"},
+        {"undo", "=\n\n"},
+        {"undo", "=\n\n"},
+        {"play w B8", "=\n\n"},
+        {"known_command undo", "= true\n\n"},
+        {"known_command foo", "= false\n\n"},
+        {"foo", "? unknown command\n\n"},
+        {"", ""},
+        {"final_score", "= W+7.5\n\n"},
+        {"clear_board", "=\n\n"},
+        {"final_score", "= W+6.5\n\n"},
+        {"2 quit", "=2\n\n"},
+    };
+
+    int failed = 0;
+    for (auto &&step : session) {
+        const std::string response = engine.execute(step[0]);
+        if (response != step[1]) {
+            std::cout << "'" << step[0] << "' answered '" << response << "'" << std::endl;
+            failed++;
+        }
+    }
+    failed += !engine.finished();
+    std::cout << "test_case001 failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int test_case002() {
+    // legal masks of random games (captures, ko, suicide) equal is_legal of the board
+    const int N = 9;
+    int failed = 0, positions = 0;
+    for (int g = 0; g < 20; ++g) {
+        basic_game_t<N> game;
+        fast_rng_t rng(g + 1);
+        for (int m = 0; m < 120; ++m) {
+            const token_t tok = game.to_move();
+            int mask[N * N];
+            game.legal_mask(mask, tok);
+            std::vector<int> legal;
+            for (int p = 0; p < N * N; ++p) {
+                failed += (mask[p] != game.board().is_legal({p / N, p % N}, tok));
+                if (mask[p] && !game.board().looks_like_an_eye({p / N, p % N}, tok))
+                    legal.push_back(p);
+            }
+            positions++;
+            if (legal.empty()) {
+                game.play({-1, -1}, tok);
+                continue;
+            }
+            const int p = legal[rng.uniform(legal.size())];
+            failed += !game.play({p / N, p % N}, tok);
+        }
+    }
+    std::cout << "test_case002 " << positions << " positions, failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int test_case003() {
+    // undo restores board, hash and player to move
+    basic_game_t<9> game;
+    fast_rng_t rng(5);
+    std::vector<basic_game_t<9> > copies;
+    for (int m = 0; m < 60; ++m) {
+        copies.push_back(game);
+        int mask[81];
+        if (game.legal_mask(mask, game.to_move()) == 0)
+            break;
+        int p;
+        do {
+            p = rng.uniform(81);
+        } while (!mask[p]);
+        game.play({p / 9, p % 9}, game.to_move());
+    }
+
+    int failed = 0;
+    while (!copies.empty()) {
+        failed += !game.undo();
+        const basic_game_t<9> &expected = copies.back();
+        failed += (game.hash() != expected.hash()) + (game.to_move() != expected.to_move());
+        for (int x = 0; x < 9; ++x)
+            for (int y = 0; y < 9; ++y)
+                failed += (game.board().fields[x][y].token() != expected.board().fields[x][y].token());
+        copies.pop_back();
+    }
+    failed += game.undo();
+    std::cout << "test_case003 failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+void benchmark() {
+    // genmove of a random policy during a 19x19 game
+    gtp_engine_t engine;
+    std::vector<double> times;
+    for (int m = 0; m < 200; ++m) {
+        auto start = std::chrono::steady_clock::now();
+        engine.execute((m % 2) ? "genmove w" : "genmove b");
+        times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    double total = 0;
+    for (double t : times)
+        total += t;
+    std::cout << "genmove: " << 1e6 * total / times.size() << " us per move (legal mask, planes, policy)" << std::endl;
+
+    // legal mask against one is_legal per field
+    game_t game;
+    for (int m = 0; m < 100; ++m) {
+        int mask[361];
+        game.legal_mask(mask, game.to_move());
+        for (int p = 0; p < 361; ++p)
+            if (mask[(p * 37 + m) % 361]) {
+                game.play({(p * 37 + m) % 361 / 19, (p * 37 + m) % 361 % 19}, game.to_move());
+                break;
+            }
+    }
+    int mask[361];
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i)
+        game.legal_mask(mask, black);
+    const double fast = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 100;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; ++i)
+        for (int p = 0; p < 361; ++p)
+            mask[p] = game.is_legal({p / 19, p % 19}, black);
+    const double slow = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 10;
+    std::cout << "legal mask: " << 1e6 * fast << " us vs. " << 1e6 * slow << " us with is_legal per field" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+    int failed = test_case001() + test_case002() + test_case003();
+    std::cout << "failed " << failed << " vs. 0" << std::endl;
+
+    benchmark();
+    return 0;
+}
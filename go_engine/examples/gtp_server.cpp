@@ -0,0 +1,221 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+
+#include "eval_broker.h"
+#include "gtp_engine.h"
+#include "gtp_server.h"
+#include "policy_net.h"
+
+// concurrent GTP sessions over a Unix socket sharing one batched backend
+
+const char *socket_path = "/tmp/tfgo_gtp_server_example.sock";
+
+int connect_to(const char *path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (sockaddr*) &address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// read a single response (terminated by an empty line), empty if the server closed
+std::string response(int fd, std::string *buffer) {
+    while (true) {
+        const size_t end = buffer->find("\n\n");
+        if (end != std::string::npos) {
+            const std::string r = buffer->substr(0, end + 2);
+            buffer->erase(0, end + 2);
+            return r;
+        }
+        char data[1024];
+        const ssize_t n = read(fd, data, sizeof(data));
+        if (n <= 0)
+            return "";
+        buffer->append(data, n);
+    }
+}
+
+std::vector<std::string> game(int client) {
+    // a different opening per client, then the policy plays both colors
+    const char *columns = "ABCDEFGHJKLMNOPQRST";
+    std::vector<std::string> commands = {"boardsize 19", "komi 6.5", "clear_board"};
+    commands.push_back(std::string("play b ") + columns[client % 19] + "10");
+    for (int i = 0; i < 6; ++i)
+        commands.push_back((i % 2) ? "genmove b" : "genmove w");
+    commands.push_back("final_score");
+    return commands;
+}
+
+int test_case001() {
+    // sessions of concurrent clients answer as independent engines, genmoves share batches
+    const int clients = 8;
+    mock_backend_t backend(47 * 19 * 19, 19 * 19, 2000);
+    eval_broker_t broker(&backend, clients, 20000);
+    gtp_server_t server(&broker, 47, clients);
+    if (!server.listen(socket_path))
+        return 1;
+    std::thread serving([&]() { server.run(); });
+
+    std::vector<std::vector<std::string>> transcripts(clients);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; ++c)
+        threads.push_back(std::thread([&, c]() {
+            const int fd = connect_to(socket_path);
+            if (fd < 0)
+                return;
+            std::string buffer;
+            for (auto &&command : game(c)) {
+                const std::string line = command + "\n";
+                if (write(fd, line.data(), line.size()) != (ssize_t) line.size())
+                    break;
+                transcripts[c].push_back(response(fd, &buffer));
+            }
+            close(fd);
+        }));
+    for (auto &&t : threads)
+        t.join();
+
+    // the same games by a single engine with an unshared broker
+    mock_backend_t reference_backend(47 * 19 * 19, 19 * 19);
+    eval_broker_t reference_broker(&reference_backend, 1, 0);
+    int failed = 0;
+    for (int c = 0; c < clients; ++c) {
+        broker_gtp_policy_t policy(&reference_broker, 47);
+        gtp_engine_t engine(&policy);
+        const std::vector<std::string> commands = game(c);
+        failed += (transcripts[c].size() != commands.size());
+        for (size_t i = 0; i < commands.size() && i < transcripts[c].size(); ++i) {
+            const std::string expected = engine.execute(commands[i]);
+            if (transcripts[c][i] != expected) {
+                std::cout << "client " << c << " '" << commands[i] << "' answered '"
+                          << transcripts[c][i] << "' instead of '" << expected << "'" << std::endl;
+                failed++;
+            }
+        }
+    }
+
+    failed += (server.commands() != (std::uint64_t) clients * game(0).size());
+    failed += (broker.requests() != (std::uint64_t) clients * 6);
+    failed += (broker.mean_batch_size() <= 1.f);
+    std::cout << "test_case001 mean batch size " << broker.mean_batch_size() << std::endl;
+
+    // closed connections end their sessions
+    for (int i = 0; i < 100 && server.sessions() > 0; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    failed += (server.sessions() != 0);
+
+    server.stop();
+    serving.join();
+    std::cout << "test_case001 failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int test_case002() {
+    // pipelined commands are answered in order, quit closes the connection
+    gtp_server_t server(nullptr, 47, 4);
+    if (!server.listen(socket_path))
+        return 1;
+    std::thread serving([&]() { server.run(); });
+
+    int failed = 0;
+    const int fd = connect_to(socket_path);
+    failed += (fd < 0);
+    if (fd >= 0) {
+        const std::string lines = "1 name\n2 play b D4\n3 play w D4\nboardsize 9\r\n4 quit\nname\n";
+        failed += (write(fd, lines.data(), lines.size()) != (ssize_t) lines.size());
+        const char *expected[] = {"=1 tfgo\n\n", "=2\n\n", "?3 illegal move\n\n", "=\n\n", "=4\n\n", ""};
+        std::string buffer;
+        for (const char *e : expected) {
+            const std::string r = response(fd, &buffer);
+            if (r != e) {
+                std::cout << "answered '" << r << "' instead of '" << e << "'" << std::endl;
+                failed++;
+            }
+        }
+        close(fd);
+    }
+
+    server.stop();
+    serving.join();
+    failed += (server.sessions() != 0);
+    std::cout << "test_case002 failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int test_case003() {
+    // the server with the native net picks the moves of tools/gtp (logits, not per-row softmax)
+    {
+        // a single 3x3 convolution with pseudo-random weights
+        std::ofstream out("gtp_server_test.bin", std::ios::binary);
+        const std::int32_t header[7] = {1, 1, 3, 47, 1, 1, 0};
+        out.write("TFGO", 4);
+        out.write((const char*) header, sizeof(header));
+        std::uint32_t state = 12345;
+        for (int i = 0; i < 3 * 3 * 47 + 1; ++i) {
+            state = state * 1664525u + 1013904223u;
+            const float w = (state >> 8) / (float) (1 << 24) - 0.5f;
+            out.write((const char*) &w, sizeof(w));
+        }
+    }
+    policy_net_t net;
+    int failed = !net.load("gtp_server_test.bin");
+    std::remove("gtp_server_test.bin");
+
+    policy_net_backend_t backend(&net, true);
+    eval_broker_t broker(&backend, 4, 2000);
+    gtp_server_t server(&broker, net.planes(), 4);
+    if (!server.listen(socket_path))
+        return 1;
+    std::thread serving([&]() { server.run(); });
+
+    for (int c = 0; c < 2; ++c) {
+        const int fd = connect_to(socket_path);
+        failed += (fd < 0);
+        if (fd < 0)
+            break;
+        policy_net_gtp_policy_t policy(&net);
+        gtp_engine_t engine(&policy);
+        std::string buffer;
+        for (auto &&command : game(c)) {
+            const std::string line = command + "\n";
+            failed += (write(fd, line.data(), line.size()) != (ssize_t) line.size());
+            const std::string r = response(fd, &buffer);
+            const std::string expected = engine.execute(command);
+            if (r != expected) {
+                std::cout << "'" << command << "' answered '" << r << "' instead of '" << expected
+                          << "'" << std::endl;
+                failed++;
+            }
+        }
+        close(fd);
+    }
+
+    server.stop();
+    serving.join();
+    std::cout << "test_case003 failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int main(int argc, char const *argv[]) {
+    test_case001();
+    test_case002();
+    test_case003();
+    return 0;
+}
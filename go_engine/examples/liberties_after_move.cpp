@@ -0,0 +1,65 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "../src/token_t.h"
+#include "../src/field_t.h"
+#include "../src/group_t.h"
+#include "../src/board_t.h"
+#include "../src/sgfbin.h"
+
+// "liberties after move" against a brute-force reference which plays every move on a copy
+
+int brute_force(const board_t &b, int h, int w, token_t self) {
+    if (!b.is_legal({h, w}, self))
+        return 0;
+    board_t *copy = b.clone();
+    copy->fields[h][w].token(self);
+    copy->update_groups({h, w});
+    copy->count_and_remove_captured_stones(h, w, b.opponent(self));
+    const int liberties = copy->liberties(h, w);
+    delete copy;
+    return liberties;
+}
+
+void test_case001() {
+    // all positions of the bundled games for both players
+    const char *files[] = {"../../data/game.sgfbin",
+                           "../../data/ladder_capture.sgfbin",
+                           "../../data/2p0y-gokifu-20170527-Ke_Jie-AlphaGo.sgfbin"};
+    long checks = 0, failed = 0;
+    double secs_fast = 0, secs_brute = 0;
+
+    for (auto &&fn : files) {
+        SGFbin game(fn);
+        const std::vector<move_t> &actions = game.moves();
+        board_t b;
+        for (auto &&m : actions) {
+            if (m.kind != move_t::pass)
+                b.play({m.row(), m.col()}, m.player());
+
+            for (token_t self : {black, white}) {
+                int values[19 * 19];
+                const auto start = std::chrono::steady_clock::now();
+                b.liberties_after_move(values, self);
+                const auto mid = std::chrono::steady_clock::now();
+                for (int h = 0; h < 19; ++h)
+                    for (int w = 0; w < 19; ++w) {
+                        checks++;
+                        if (brute_force(b, h, w, self) != values[19 * h + w])
+                            failed++;
+                    }
+                const auto end = std::chrono::steady_clock::now();
+                secs_fast += std::chrono::duration<double>(mid - start).count();
+                secs_brute += std::chrono::duration<double>(end - mid).count();
+            }
+        }
+    }
+    std::cout << "checked " << checks << " fields, failed " << failed << " vs. 0" << std::endl;
+    std::cout << "time " << secs_fast << "s vs. brute-force " << secs_brute << "s" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+    test_case001();
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../src/sgfbin.h"
+#include "../tools/sgflmdb.h"
+
+// read games from a LMDB database (go_db.py --action create) without copying them
+
+void test_case001(const SGFlmdb &db) {
+    // sequential scan of all games in key order
+    SGFlmdb::reader_t reader(db);
+    for (size_t i = 0; i < db.size(); ++i) {
+        const unsigned char *raw = nullptr;
+        int len = 0;
+        if (!reader.next(&raw, &len)) {
+            std::cout << "cannot read game " << i << std::endl;
+            continue;
+        }
+        SGFbin game(raw, len, true);
+        std::cout << "game " << i << ": " << len << " bytes, " << game.num_actions()
+                  << " actions, valid " << game.valid() << " vs. 1" << std::endl;
+    }
+}
+
+void test_case002(const SGFlmdb &db) {
+    // random sampling by several threads, each with its own read-only transaction
+    const int num_threads = 4;
+    const int samples = 100000;
+    std::atomic<long> actions(0);
+    std::atomic<int> failed(0);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            std::mt19937 rng(t);
+            SGFlmdb::reader_t reader(db);
+            long local = 0;
+            for (int i = 0; i < samples; ++i) {
+                const unsigned char *raw = nullptr;
+                int len = 0;
+                if (!reader.game(rng() % db.size(), &raw, &len)) {
+                    failed++;
+                    continue;
+                }
+                SGFbin game(raw, len, true);
+                local += game.moves().size();
+                if (i % 1000 == 0)
+                    reader.refresh();
+            }
+            actions += local;
+        }));
+    }
+    for (auto &&t : threads)
+        t.join();
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << num_threads * samples / secs << " games/s (" << actions << " actions), failed "
+              << failed << " vs. 0" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+    SGFlmdb db((argc > 1) ? argv[1] : "../../data/testgo.lmdb");
+    std::cout << "found " << db.size() << " games" << std::endl;
+    if (!db.valid() || db.size() == 0)
+        return 1;
+    test_case001(db);
+    test_case002(db);
+    return 0;
+}
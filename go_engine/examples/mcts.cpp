@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <utility>
+
+#include "playout.h"
+#include "mcts.h"
+
+// PUCT search and simulations/s with rollouts for several threads
+
+// deterministic stand-in for a value network: the current area score
+class score_evaluator_t : public basic_evaluator_t<9> {
+  public:
+    float evaluate(const basic_playout_t<9> &position, token_t to_move, float *priors) {
+        for (int i = 0; i < 9 * 9 + 1; ++i)
+            priors[i] = 1.f;
+        const float value = std::tanh(position.score(7.5f) / 10.f);
+        return (to_move == black) ? value : -value;
+    }
+};
+
+int test_case001(int threads) {
+    // a large white group in atari (last liberty at (4, 7)), black to move
+    const int N = 9;
+    basic_playout_t<N> position;
+    for (int y = 2; y < 7; ++y) {
+        position.play({4, y}, white);
+        position.play({3, y}, black);
+        position.play({5, y}, black);
+    }
+    position.play({4, 1}, black);
+    position.play({0, 0}, white);
+
+    score_evaluator_t evaluator;
+    basic_mcts_t<N> search(&evaluator, threads);
+    search.set_position(position, black);
+    const int simulations = search.search(2000);
+
+    // every simulation but the first one (expanding the root) visits a child of the root
+    int total = search.visits({-1, -1});
+    for (int x = 0; x < N; ++x)
+        for (int y = 0; y < N; ++y)
+            total += search.visits({x, y});
+
+    int failed = (search.best_move() != coord_t(4, 7));
+    failed += (total != simulations - 1);
+    std::cout << threads << " threads: best move (" << search.best_move().first << ", " << search.best_move().second
+              << ") with " << search.visits(search.best_move()) << " visits, value " << search.value(search.best_move())
+              << ", failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+template<int N>
+void benchmark(int simulations) {
+    basic_rollout_evaluator_t<N> evaluator(7.5f);
+    double base = 0;
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        basic_mcts_t<N> search(&evaluator, threads);
+        search.set_position(basic_playout_t<N>(), black);
+        auto start = std::chrono::steady_clock::now();
+        const int done = search.search(simulations);
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (threads == 1)
+            base = done / secs;
+        std::cout << N << "x" << N << ", " << threads << " threads: " << done / secs << " simulations/s ("
+                  << (done / secs) / base << "x), " << search.collisions() << " collisions, "
+                  << search.num_nodes() << " nodes in tree" << std::endl;
+    }
+}
+
+int main(int argc, char const *argv[]) {
+    int failed = test_case001(1) + test_case001(4);
+    std::cout << "failed " << failed << " vs. 0" << std::endl;
+
+    benchmark<9>(10000);
+    benchmark<19>(2000);
+    return 0;
+}
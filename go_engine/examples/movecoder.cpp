@@ -0,0 +1,154 @@
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../src/sgfbin.h"
+#include "../src/movecoder.h"
+
+// round-trip of compressed move streams against the raw 2-byte encoding
+
+std::vector<unsigned char> read_raw(SGFbin &game) {
+    std::vector<unsigned char> raw;
+    for (unsigned int i = 0; i < game.num_actions(); ++i) {
+        int x = 0, y = 0;
+        bool is_white = false, is_move = false, is_pass = false;
+        game.parse(i, &x, &y, &is_white, &is_move, &is_pass);
+        const int value = game.flags(i) + 4096 * is_pass + 2048 * is_move + 1024 * is_white + 32 * y + x;
+        raw.push_back(value >> 8);
+        raw.push_back(value & 0xff);
+    }
+    return raw;
+}
+
+bool roundtrip(const std::vector<unsigned char> &raw) {
+    sgfbin_header_t h;
+    h.flags = sgfbin_header_t::compressed;
+    std::vector<unsigned char> stream = move_encoder_t::compress(raw.data(), raw.size());
+    std::vector<unsigned char> file(sgfbin_header_t::length);
+    h.encode(file.data(), stream.data(), stream.size());
+    file.insert(file.end(), stream.begin(), stream.end());
+
+    SGFbin game(file.data(), file.size());
+    if (!game.valid() || game.num_actions() != raw.size() / 2)
+        return false;
+    return read_raw(game) == raw;
+}
+
+void test_case001() {
+    // bundled games
+    const char *files[] = {"../../data/game.sgfbin",
+                           "../../data/ladder_capture.sgfbin",
+                           "../../data/2p0y-gokifu-20170527-Ke_Jie-AlphaGo.sgfbin"};
+    for (auto &&fn : files) {
+        SGFbin game(fn);
+        std::vector<unsigned char> raw = read_raw(game);
+        std::vector<unsigned char> stream = move_encoder_t::compress(raw.data(), raw.size());
+        std::cout << fn << ": " << raw.size() << " -> " << stream.size() << " bytes, roundtrip "
+                  << roundtrip(raw) << " vs. 1" << std::endl;
+    }
+}
+
+void test_case002() {
+    // random games including passes, set stones, flags and empty games
+    std::mt19937 rng(42);
+    int failed = 0;
+    for (int n = 0; n < 1000; ++n) {
+        std::vector<unsigned char> raw;
+        const int len = rng() % 400;
+        for (int i = 0; i < len; ++i) {
+            const int value = rng() & 0xffff;
+            raw.push_back(value >> 8);
+            raw.push_back(value & 0xff);
+        }
+        failed += !roundtrip(raw);
+    }
+    std::cout << "random games failed " << failed << " vs. 0" << std::endl;
+}
+
+void test_case003() {
+    // the most compressible games fit the bound on actions per byte, corrupt counts are rejected
+    int failed = 0;
+    std::vector<unsigned char> raw;
+    for (int i = 0; i < 100000; ++i) {
+        raw.push_back(4096 >> 8);
+        raw.push_back(0);
+    }
+    failed += !roundtrip(raw);
+
+    std::vector<unsigned char> stream = move_encoder_t::compress(raw.data(), raw.size());
+    std::cout << "100000 passes -> " << stream.size() << " bytes" << std::endl;
+    stream[0] |= 128;
+    stream[1] |= 128;
+    stream.insert(stream.begin() + 2, {0xff, 0x0f});
+    sgfbin_header_t h;
+    h.flags = sgfbin_header_t::compressed;
+    std::vector<unsigned char> file(sgfbin_header_t::length);
+    h.encode(file.data(), stream.data(), stream.size());
+    file.insert(file.end(), stream.begin(), stream.end());
+    SGFbin corrupt(file.data(), file.size());
+    failed += corrupt.valid() + (corrupt.num_actions() != 0) + (corrupt.moves().size() != 0);
+    std::cout << "corrupt counts failed " << failed << " vs. 0" << std::endl;
+}
+
+void test_case004() {
+    // copies outlive the original, for plain and compressed (partially decoded) games
+    int failed = 0;
+    SGFbin plain("../../data/2p0y-gokifu-20170527-Ke_Jie-AlphaGo.sgfbin");
+    const std::vector<unsigned char> raw = read_raw(plain);
+
+    sgfbin_header_t h;
+    h.flags = sgfbin_header_t::compressed;
+    std::vector<unsigned char> stream = move_encoder_t::compress(raw.data(), raw.size());
+    std::vector<unsigned char> file(sgfbin_header_t::length);
+    h.encode(file.data(), stream.data(), stream.size());
+    file.insert(file.end(), stream.begin(), stream.end());
+
+    for (int compressed = 0; compressed < 2; ++compressed) {
+        SGFbin *original = compressed ? new SGFbin(file.data(), file.size())
+                                      : new SGFbin("../../data/2p0y-gokifu-20170527-Ke_Jie-AlphaGo.sgfbin");
+        int x, y;
+        bool is_white, is_move, is_pass;
+        original->parse(10, &x, &y, &is_white, &is_move, &is_pass);
+        SGFbin copy(*original);
+        SGFbin assigned("../../data/game.sgfbin");
+        assigned = *original;
+        delete original;
+        failed += (read_raw(copy) != raw) + (read_raw(assigned) != raw);
+        failed += (copy.moves().size() != raw.size() / 2) + !copy.valid();
+    }
+
+    // borrowed buffers stay borrowed
+    SGFbin borrowed(file.data(), file.size(), true);
+    SGFbin copy(borrowed);
+    failed += (read_raw(copy) != raw);
+    std::cout << "copies failed " << failed << " vs. 0" << std::endl;
+}
+
+void test_case005() {
+    // replay speed
+    SGFbin original("../../data/2p0y-gokifu-20170527-Ke_Jie-AlphaGo.sgfbin");
+    std::vector<unsigned char> raw = read_raw(original);
+    std::vector<unsigned char> stream = move_encoder_t::compress(raw.data(), raw.size());
+
+    const int repeats = 10000;
+    auto start = std::chrono::steady_clock::now();
+    unsigned int sum = 0;
+    for (int r = 0; r < repeats; ++r) {
+        move_decoder_t decoder;
+        decoder.reset(stream.data(), stream.size());
+        for (unsigned int i = 0; i < decoder.num_actions(); ++i)
+            sum += decoder.next();
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "decoded " << (repeats * raw.size() / 2 / secs / 1e6) << "M moves/s (" << sum % 2 << ")" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+    test_case001();
+    test_case002();
+    test_case003();
+    test_case004();
+    test_case005();
+}
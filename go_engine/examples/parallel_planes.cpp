@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "misc.h"
+#include "token_t.h"
+#include "board_t.h"
+#include "playout.h"
+#include "thread_pool.h"
+
+// feature planes of a single position computed by several threads, latency at 1, 2, 4, 8 threads
+
+// random game of a number of moves
+board_t* position(int moves, std::uint64_t seed) {
+    board_t *b = new board_t();
+    fast_rng_t rng(seed);
+    token_t tok = black;
+    for (int m = 0; m < moves; ++m) {
+        for (int attempt = 0; attempt < 100; ++attempt) {
+            const int f = rng.uniform(361);
+            if (b->is_legal({f / 19, f % 19}, tok) && !b->looks_like_an_eye({f / 19, f % 19}, tok)) {
+                b->play({f / 19, f % 19}, tok);
+                break;
+            }
+        }
+        tok = b->opponent(tok);
+    }
+    return b;
+}
+
+int test_case001() {
+    // any number of threads gives the planes of a single thread
+    int failed = 0;
+    std::vector<std::unique_ptr<thread_pool_t>> pools;
+    for (int threads : {2, 4, 8})
+        pools.emplace_back(new thread_pool_t(threads - 1));
+
+    for (int g = 0; g < 6; ++g) {
+        std::unique_ptr<board_t> b(position(40 + 30 * g, g + 1));
+        for (token_t self : {black, white}) {
+            std::vector<int> expected(49 * 361, 0);
+            b->feature_planes(expected.data(), self);
+            for (auto &&pool : pools) {
+                std::vector<int> planes(49 * 361, 0);
+                b->feature_planes(planes.data(), self, pool.get());
+                failed += (planes != expected);
+            }
+        }
+    }
+    std::cout << "test_case001 failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+void benchmark() {
+    // median latency of the planes of one mid-game position
+    std::unique_ptr<board_t> b(position(160, 7));
+    std::vector<int> planes(49 * 361);
+    for (int threads : {1, 2, 4, 8}) {
+        std::unique_ptr<thread_pool_t> pool((threads > 1) ? new thread_pool_t(threads - 1) : nullptr);
+        std::vector<double> times;
+        for (int r = 0; r < 15; ++r) {
+            std::fill(planes.begin(), planes.end(), 0);
+            auto start = std::chrono::steady_clock::now();
+            b->feature_planes(planes.data(), black, pool.get());
+            times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        std::cout << threads << " threads: " << 1e3 * times[times.size() / 2] << " ms per position" << std::endl;
+    }
+    std::cout << "(" << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+    test_case001();
+    benchmark();
+    return 0;
+}
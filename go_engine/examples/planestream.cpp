@@ -0,0 +1,74 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "../src/sgfbin.h"
+#include "../src/replay.h"
+#include "../src/planestream.h"
+
+// delta encoded feature planes of all positions against separate replays
+
+void test_case001() {
+    const char *files[] = {"../../data/game.sgfbin",
+                           "../../data/ladder_capture.sgfbin",
+                           "../../data/2p0y-gokifu-20170527-Ke_Jie-AlphaGo.sgfbin"};
+    for (auto &&fn : files) {
+        SGFbin game(fn);
+        std::vector<unsigned char> stream;
+        std::vector<int> next_moves;
+        const auto start = std::chrono::steady_clock::now();
+        const int frames = play_game_stream(&game, &stream, &next_moves);
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        plane_stream_decoder_t decoder;
+        std::vector<int> decoded(49 * 19 * 19);
+        int pos = 0, failed = 0;
+        for (int m = 1; m <= frames; ++m) {
+            const int used = decoder.decode(stream.data() + pos, stream.size() - pos, decoded.data());
+            if (used < 0) {
+                failed++;
+                break;
+            }
+            pos += used;
+
+            SGFbin reference(fn);
+            std::vector<int> planes(49 * 19 * 19, 0);
+            const int next_move = play_game(&reference, planes.data(), m);
+            if (planes != decoded || next_move != next_moves[m - 1])
+                failed++;
+        }
+
+        const double full = 49. * 19 * 19 * 4 * frames;
+        std::cout << fn << ": " << frames << " positions in " << stream.size() << " bytes ("
+                  << stream.size() / (double) std::max(1, frames) << " bytes/position, " << full / stream.size()
+                  << "x smaller than int32 planes, " << frames / secs << " positions/s), failed "
+                  << failed << " vs. 0" << std::endl;
+    }
+}
+
+void test_case002() {
+    // corrupt (truncated) frames are rejected without changing the state of the decoder
+    SGFbin game("../../data/2p0y-gokifu-20170527-Ke_Jie-AlphaGo.sgfbin");
+    std::vector<unsigned char> stream;
+    std::vector<int> next_moves;
+    const int frames = play_game_stream(&game, &stream, &next_moves);
+
+    plane_stream_decoder_t decoder, reference;
+    std::vector<int> decoded(49 * 19 * 19), expected(49 * 19 * 19);
+    int pos = 0, failed = 0, rejected = 0;
+    for (int m = 1; m <= frames; ++m) {
+        const int used = reference.decode(stream.data() + pos, stream.size() - pos, expected.data());
+        if (used > 1)
+            rejected += (decoder.decode(stream.data() + pos, used - 1, decoded.data()) == -1);
+        failed += (decoder.decode(stream.data() + pos, used, decoded.data()) != used);
+        failed += (decoded != expected);
+        pos += used;
+    }
+    std::cout << "rejected " << rejected << " truncated frames, failed " << failed << " vs. 0" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+    test_case001();
+    test_case002();
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "board_t.h"
+#include "playout.h"
+
+// random playouts checked against board_t and playouts/s
+
+template<int N>
+int test_case001(int games) {
+    int failed = 0, compared = 0;
+    for (int g = 0; g < games; ++g) {
+        basic_playout_t<N> playout(g + 1);
+        basic_board_t<N> b;
+        token_t tok = black;
+
+        for (int step = 0; step < 3 * N * N && !playout.finished(); ++step) {
+            const coord_t pos = playout.play_random(tok);
+            if (pos.first >= 0) {
+                // ko and super-ko are handled differently by board_t
+                if (!b.is_legal(pos, tok))
+                    break;
+                b.play(pos, tok);
+            }
+            tok = b.opponent(tok);
+
+            if (step % 8 != 0)
+                continue;
+
+            // same stones and legal moves (apart from ko and super-ko which board_t handles differently)
+            basic_playout_t<N> loaded;
+            loaded.load(b);
+            for (int x = 0; x < N; ++x)
+                for (int y = 0; y < N; ++y) {
+                    failed += (playout.token({x, y}) != b.fields[x][y].token());
+                    if (b.ko == coord_t(x, y) || contains(b.hash_history, b.rehash({x, y}, tok)))
+                        continue;
+                    const bool legal = b.is_legal({x, y}, tok);
+                    failed += (legal != playout.is_legal({x, y}, tok));
+                    failed += (legal != loaded.is_legal({x, y}, tok));
+                    compared++;
+                }
+        }
+    }
+    std::cout << N << "x" << N << ": compared " << compared << " fields, failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+template<int N>
+void benchmark(int threads, double seconds) {
+    std::vector<long> playouts(threads, 0), moves(threads, 0);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+        workers.push_back(std::thread([&, t]() {
+            basic_playout_t<N> playout(t + 1);
+            double score = 0;
+            while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+                for (int i = 0; i < 100; ++i) {
+                    playout.clear();
+                    moves[t] += playout.run(black);
+                    score += playout.score(7.5f);
+                    playouts[t]++;
+                }
+            }
+        }));
+    for (auto &&w : workers)
+        w.join();
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long total = 0, total_moves = 0;
+    for (int t = 0; t < threads; ++t) {
+        total += playouts[t];
+        total_moves += moves[t];
+    }
+    std::cout << N << "x" << N << ": " << total / secs / threads << " playouts/s per core ("
+              << threads << " threads, " << (double) total_moves / total << " moves per playout)" << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+    int failed = test_case001<9>(50) + test_case001<19>(5);
+    std::cout << "failed " << failed << " vs. 0" << std::endl;
+
+    const int threads = std::max(1u, std::thread::hardware_concurrency());
+    benchmark<9>(1, 1.0);
+    benchmark<19>(1, 1.0);
+    if (threads > 1) {
+        benchmark<9>(threads, 1.0);
+        benchmark<19>(threads, 1.0);
+    }
+    return 0;
+}
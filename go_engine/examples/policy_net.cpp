@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "misc.h"
+#include "token_t.h"
+#include "board_t.h"
+#include "playout.h"
+#include "policy_net.h"
+
+// native policy net against a direct convolution (and TensorFlow outputs if given), speed
+
+struct layer_spec_t {
+    int kernel, in, out;
+    bool bias, relu;
+    std::vector<float> weights, b;
+};
+
+// the architecture of tfgo.py with random weights
+std::vector<layer_spec_t> random_net(int planes, int k) {
+    fast_rng_t rng(7);
+    std::vector<layer_spec_t> layers;
+    for (int l = 0; l < 13; ++l) {
+        layer_spec_t s;
+        s.kernel = (l == 0) ? 5 : ((l == 12) ? 1 : 3);
+        s.in = (l == 0) ? planes : k;
+        s.out = (l == 12) ? 1 : k;
+        s.bias = s.relu = false;
+        if (l == 12)
+            s.bias = true;
+        else
+            s.relu = true;
+        const float scale = std::sqrt(6.f / (s.kernel * s.kernel * s.in));
+        for (int i = 0; i < s.kernel * s.kernel * s.in * s.out; ++i)
+            s.weights.push_back(scale * (rng.uniform(2001) / 1000.f - 1.f));
+        if (s.bias)
+            s.b.push_back(0.25f);
+        layers.push_back(s);
+    }
+    return layers;
+}
+
+void write_net(const std::vector<layer_spec_t> &layers, const char *path) {
+    std::ofstream out(path, std::ios::binary);
+    const std::int32_t header[2] = {1, (std::int32_t) layers.size()};
+    out.write("TFGO", 4);
+    out.write((const char*) header, sizeof(header));
+    for (const layer_spec_t &s : layers) {
+        const std::int32_t shape[5] = {s.kernel, s.in, s.out, s.bias, s.relu};
+        out.write((const char*) shape, sizeof(shape));
+        out.write((const char*) s.weights.data(), s.weights.size() * sizeof(float));
+        out.write((const char*) s.b.data(), s.b.size() * sizeof(float));
+    }
+}
+
+// tf.pad followed by a VALID convolution, weights in HWIO
+std::vector<float> direct(const std::vector<layer_spec_t> &layers, const float *input) {
+    std::vector<float> x(input, input + layers[0].in * 361);
+    for (const layer_spec_t &s : layers) {
+        const int pad = s.kernel / 2;
+        std::vector<float> y(s.out * 361, 0.f);
+        for (int o = 0; o < s.out; ++o)
+            for (int r = 0; r < 19; ++r)
+                for (int c = 0; c < 19; ++c) {
+                    double sum = s.bias ? s.b[o] : 0;
+                    for (int dy = 0; dy < s.kernel; ++dy)
+                        for (int dx = 0; dx < s.kernel; ++dx) {
+                            const int rr = r + dy - pad, cc = c + dx - pad;
+                            if (rr < 0 || rr >= 19 || cc < 0 || cc >= 19)
+                                continue;
+                            for (int i = 0; i < s.in; ++i)
+                                sum += x[i * 361 + rr * 19 + cc] *
+                                       s.weights[((dy * s.kernel + dx) * s.in + i) * s.out + o];
+                        }
+                    y[o * 361 + r * 19 + c] = s.relu ? std::max(0.0, sum) : sum;
+                }
+        x.swap(y);
+    }
+    return x;
+}
+
+// feature planes of a few positions of a random game
+std::vector<int> positions(int batch) {
+    std::vector<int> planes(batch * 49 * 361, 0);
+    board_t b;
+    fast_rng_t rng(3);
+    token_t tok = black;
+    for (int n = 0; n < batch; ++n) {
+        for (int m = 0; m < 20;) {
+            const coord_t pos(rng.uniform(19), rng.uniform(19));
+            if (b.is_legal(pos, tok) && b.play(pos, tok)) {
+                tok = (tok == black) ? white : black;
+                m++;
+            }
+        }
+        b.feature_planes(planes.data() + n * 49 * 361, tok);
+    }
+    return planes;
+}
+
+int test_case001() {
+    // im2col + GEMM against the direct convolution on feature planes
+    const int batch = 3;
+    std::vector<layer_spec_t> layers = random_net(49, 16);
+    write_net(layers, "policy_net_test.bin");
+    policy_net_t net;
+    int failed = !net.load("policy_net_test.bin");
+    std::remove("policy_net_test.bin");
+    failed += (net.planes() != 49) + (net.filters() != 16);
+
+    std::vector<int> planes = positions(batch);
+    std::vector<float> logits(batch * 361), threaded(batch * 361);
+    net.forward(planes.data(), 49, batch, logits.data());
+    net.set_threads(4);
+    net.forward(planes.data(), 49, batch, threaded.data());
+
+    double worst = 0;
+    for (int n = 0; n < batch; ++n) {
+        std::vector<float> input(planes.begin() + n * 49 * 361, planes.begin() + (n + 1) * 49 * 361);
+        std::vector<float> expected = direct(layers, input.data());
+        for (int i = 0; i < 361; ++i)
+            worst = std::max(worst, (double) std::abs(expected[i] - logits[n * 361 + i]) /
+                                    std::max(1.0, (double) std::abs(expected[i])));
+    }
+    failed += (worst > 1e-4);
+    failed += (logits != threaded);
+
+    std::vector<float> prob(batch * 361);
+    policy_net_t::probabilities(logits.data(), batch, prob.data());
+    float total = 0;
+    for (int i = 0; i < 19; ++i)
+        total += prob[i];
+    failed += (std::abs(total - 1.f) > 1e-5);
+
+    std::cout << "test_case001 largest relative error " << worst << ", failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int test_case002() {
+    // invalid files
+    policy_net_t net;
+    std::ofstream("policy_net_test.bin", std::ios::binary).write("TFGO\1\0\0\0\1\0\0\0\5\0", 14);
+    int failed = net.load("policy_net_test.bin");
+    std::remove("policy_net_test.bin");
+    failed += net.load("does_not_exist.bin");
+    failed += net.loaded();
+    std::cout << "test_case002 failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int compare_with_tensorflow(const char *weights, const char *reference) {
+    // files of export_weights.py --reference
+    policy_net_t net;
+    if (!net.load(weights))
+        return 1;
+    std::ifstream in(reference, std::ios::binary);
+    std::int32_t shape[2];
+    in.read((char*) shape, sizeof(shape));
+    const int batch = shape[0], planes = shape[1];
+    std::vector<float> input(batch * planes * 361), expected(batch * 361);
+    in.read((char*) input.data(), input.size() * sizeof(float));
+    in.read((char*) expected.data(), expected.size() * sizeof(float));
+    if (!in || planes != net.planes()) {
+        std::cerr << "invalid reference " << reference << std::endl;
+        return 1;
+    }
+
+    std::vector<float> logits(batch * 361), prob(batch * 361);
+    net.forward(input.data(), batch, logits.data());
+    policy_net_t::probabilities(logits.data(), batch, prob.data());
+    float worst = 0;
+    for (int i = 0; i < batch * 361; ++i)
+        worst = std::max(worst, std::abs(prob[i] - expected[i]));
+    const int failed = (worst > 1e-4);
+    std::cout << "tensorflow: largest error " << worst << ", failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+void benchmark(int k) {
+    write_net(random_net(49, k), "policy_net_test.bin");
+    policy_net_t net;
+    net.load("policy_net_test.bin");
+    std::remove("policy_net_test.bin");
+
+    const int batch = 16;
+    std::vector<int> planes = positions(batch);
+    std::vector<float> logits(batch * 361);
+    for (int threads = 1; threads <= 4; threads *= 2)
+        for (int n = 1; n <= batch; n *= 16) {
+            net.set_threads(threads);
+            auto start = std::chrono::steady_clock::now();
+            int done = 0;
+            while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < 1.0) {
+                net.forward(planes.data(), 49, n, logits.data());
+                done += n;
+            }
+            const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "k=" << k << ", batch " << n << ", " << threads << " threads: "
+                      << done / secs << " positions/s" << std::endl;
+        }
+}
+
+int main(int argc, char const *argv[]) {
+    int failed = test_case001() + test_case002();
+    if (argc == 3)
+        failed += compare_with_tensorflow(argv[1], argv[2]);
+    std::cout << "failed " << failed << " vs. 0" << std::endl;
+
+    benchmark(128);
+    return 0;
+}
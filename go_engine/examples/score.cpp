@@ -0,0 +1,92 @@
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "board_t.h"
+#include "game.h"
+#include "playout.h"
+#include "sgfbin.h"
+#include "replay.h"
+#include "score.h"
+
+// area and territory scoring
+
+int test_case001() {
+    // black owns the first 4 columns, white the last 4, column 4 is a wall of both colors
+    //   . . . x o . . . .
+    //   . . . x o . . . .
+    //   ...
+    const int N = 9;
+    basic_board_t<N> b;
+    for (int x = 0; x < 9; ++x) {
+        b.play({x, 3}, black);
+        b.play({x, 5}, white);
+    }
+    // dame between the walls
+    int ownership[81];
+    const float area = area_score(b, 0.5f, ownership);
+    int failed = (area != (36 - 36 - 0.5f));
+    failed += (ownership[map2line(0, 4)] != 0) + (ownership[map2line(0, 0)] != 1) + (ownership[map2line(0, 8)] != -1);
+
+    // a white stone within black territory makes the region neutral for area scoring
+    b.play({4, 1}, white);
+    failed += (area_score(b, 0.5f) != (9 - 37 - 0.5f));
+    int dead[81] = {0};
+    dead[map2line(4, 1)] = 1;
+    // but it is dead: black 27 territory + 1 prisoner, white 27 territory
+    const float territory = territory_score(b, dead, 0.5f, ownership);
+    failed += (territory != (27 + 1 - 27 - 0.5f));
+    failed += (ownership[map2line(4, 1)] != 1);
+    return failed;
+}
+
+int test_case002() {
+    // finished playouts are scored the same way
+    int failed = 0;
+    double secs = 0;
+    for (int g = 0; g < 200; ++g) {
+        basic_playout_t<19> playout(g + 1);
+        playout.run(black);
+        int colors[19 * 19];
+        for (int x = 0; x < 19; ++x)
+            for (int y = 0; y < 19; ++y)
+                colors[map2line(x, y)] = playout.token({x, y});
+        auto start = std::chrono::steady_clock::now();
+        const float score = area_score<19>(colors, 7.5f);
+        secs += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        failed += (score != playout.score(7.5f));
+    }
+    std::cout << "scored 200 playouts (" << 200 / secs << " positions/s), failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int test_case003() {
+    // copies of a game keep the captured stones (prisoners of territory scoring)
+    basic_game_t<9> game;
+    game.play({0, 0}, white);
+    game.play({0, 1}, black);
+    game.play({4, 4}, white);
+    game.play({1, 0}, black);
+    int dead[81] = {0};
+    const float expected = territory_score(game.board(), dead, 0.5f);
+
+    basic_game_t<9> copy(game);
+    basic_game_t<9> assigned;
+    assigned = game;
+    int failed = (game.board().score_black != 1);
+    failed += (territory_score(copy.board(), dead, 0.5f) != expected);
+    failed += (territory_score(assigned.board(), dead, 0.5f) != expected);
+    return failed;
+}
+
+int main(int argc, char const *argv[]) {
+    int failed = test_case001() + test_case002() + test_case003();
+    std::cout << "failed " << failed << " vs. 0" << std::endl;
+
+    SGFbin game("../../data/2p0y-gokifu-20170527-Ke_Jie-AlphaGo.sgfbin");
+    std::cout << "final position of AlphaGo vs. Ke Jie (resigned, all stones alive): "
+              << play_game_score(&game, 7.5f) << " (black - white - komi)" << std::endl;
+    return 0;
+}
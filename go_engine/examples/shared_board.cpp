@@ -0,0 +1,107 @@
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "misc.h"
+#include "token_t.h"
+#include "board_t.h"
+#include "playout.h"
+
+// many threads query one shared board (build with -fsanitize=thread, see shared_board_tsan)
+
+struct queries_t {
+    std::vector<int> planes[2];
+    std::vector<int> both[2];
+    std::vector<int> liberties[2];
+    std::vector<int> legal[2];
+    std::vector<int> ladders[2];
+    std::vector<int> cloned;
+
+    bool operator==(const queries_t &other) const {
+        for (int p = 0; p < 2; ++p)
+            if (planes[p] != other.planes[p] || both[p] != other.both[p] ||
+                liberties[p] != other.liberties[p] || legal[p] != other.legal[p] ||
+                ladders[p] != other.ladders[p])
+                return false;
+        return cloned == other.cloned;
+    }
+};
+
+// all const query paths of the board
+queries_t query(const board_t &b) {
+    const token_t players[2] = {black, white};
+    queries_t q;
+    for (int p = 0; p < 2; ++p) {
+        q.planes[p].assign(49 * 361, 0);
+        b.feature_planes(q.planes[p].data(), players[p]);
+        q.liberties[p].assign(361, 0);
+        b.liberties_after_move(q.liberties[p].data(), players[p]);
+        for (int f = 0; f < 361; ++f) {
+            const coord_t pos(f / 19, f % 19);
+            q.legal[p].push_back(b.is_legal(pos, players[p]) + 2 * b.looks_like_an_eye(pos, players[p]));
+            q.ladders[p].push_back(b.is_forced_ladder_capture(pos, players[p]) +
+                                   2 * b.is_forced_ladder_escape(pos, players[p]));
+        }
+    }
+    q.both[0].assign(49 * 361, 0);
+    q.both[1].assign(49 * 361, 0);
+    b.feature_planes(q.both[0].data(), q.both[1].data(), black);
+
+    std::unique_ptr<board_t> copy(b.clone());
+    q.cloned.assign(49 * 361, 0);
+    copy->feature_planes(q.cloned.data(), black);
+    return q;
+}
+
+// random game with captures and some ataris
+board_t* position(int moves, std::uint64_t seed) {
+    board_t *b = new board_t();
+    fast_rng_t rng(seed);
+    token_t tok = black;
+    for (int m = 0; m < moves; ++m) {
+        for (int attempt = 0; attempt < 100; ++attempt) {
+            const int f = rng.uniform(361);
+            if (b->is_legal({f / 19, f % 19}, tok) && !b->looks_like_an_eye({f / 19, f % 19}, tok)) {
+                b->play({f / 19, f % 19}, tok);
+                break;
+            }
+        }
+        tok = b->opponent(tok);
+    }
+    return b;
+}
+
+int test_case001() {
+    // concurrent queries of one board give the results of a single thread
+    std::unique_ptr<board_t> b(position(160, 7));
+    const queries_t expected = query(*b);
+
+    int ladders = 0;
+    for (int p = 0; p < 2; ++p)
+        for (int v : expected.ladders[p])
+            ladders += (v != 0);
+
+    const int threads = 8;
+    std::atomic<int> wrong(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.push_back(std::thread([&]() {
+            const board_t &shared = *b;
+            wrong += !(query(shared) == expected);
+        }));
+    for (auto &&w : workers)
+        w.join();
+
+    const int failed = wrong + (ladders == 0);
+    std::cout << "test_case001 " << ladders << " ladder fields, failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int main(int argc, char const *argv[]) {
+    test_case001();
+    return 0;
+}
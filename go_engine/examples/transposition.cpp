@@ -0,0 +1,137 @@
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "playout.h"
+#include "transposition.h"
+#include "mcts.h"
+
+// keys of positions, replacement in the table, concurrent access and shared evaluations
+
+int test_case001() {
+    // the same position by different move orders
+    basic_playout_t<9> a, b;
+    a.play({2, 2}, black); a.play({6, 6}, white); a.play({2, 6}, black); a.play({6, 2}, white);
+    b.play({2, 6}, black); b.play({6, 2}, white); b.play({2, 2}, black); b.play({6, 6}, white);
+
+    int failed = (a.key(black) != b.key(black));
+    failed += (a.key(black) == a.key(white));
+
+    // white captures at (1, 1), black may not retake at (1, 2) immediately
+    basic_playout_t<9> c;
+    c.play({0, 1}, black); c.play({0, 2}, white);
+    c.play({1, 0}, black); c.play({1, 3}, white);
+    c.play({2, 1}, black); c.play({2, 2}, white);
+    c.play({1, 2}, black); c.play({1, 1}, white);
+    failed += c.is_legal({1, 2}, black);
+    basic_playout_t<9> d = c;
+    d.pass();
+    failed += (c.hash() != d.hash());
+    failed += (c.key(black) == d.key(black));
+
+    std::cout << "test_case001 failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int test_case002() {
+    // a single bucket, the oldest entry is replaced
+    basic_transposition_table_t<9> table(4);
+    float priors[82], value;
+    for (int i = 0; i < 82; ++i)
+        priors[i] = i;
+
+    int failed = 0;
+    for (int k = 1; k <= 4; ++k)
+        failed += !table.store(4 * k, k, priors);
+    table.new_generation();
+    failed += !table.lookup(8, &value, priors);
+    failed += (value != 2.f) + (priors[81] != 81.f);
+    failed += !table.store(20, 5, priors);
+
+    failed += table.lookup(4, &value, priors);
+    failed += !table.lookup(8, &value, priors);
+    failed += !table.lookup(20, &value, priors);
+    failed += (value != 5.f);
+    failed += (table.replacements() != 1) + (table.hits() != 3) + (table.lookups() != 4);
+
+    std::cout << "test_case002 failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int test_case003() {
+    // hammer a small table, every hit has to be consistent
+    basic_transposition_table_t<9> table(256);
+    std::atomic<int> inconsistent(0), hits(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+        workers.push_back(std::thread([&, t]() {
+            fast_rng_t rng(t + 1);
+            float priors[82], value;
+            for (int i = 0; i < 200000; ++i) {
+                const std::uint64_t key = 1 + rng.uniform(1000);
+                if (table.lookup(key, &value, priors)) {
+                    hits++;
+                    for (int j = 0; j < 82; ++j)
+                        inconsistent += (priors[j] != key + j);
+                    inconsistent += (value != key);
+                } else {
+                    for (int j = 0; j < 82; ++j)
+                        priors[j] = key + j;
+                    table.store(key, key, priors);
+                }
+            }
+        }));
+    for (auto &&w : workers)
+        w.join();
+
+    const int failed = (inconsistent != 0) + (hits == 0);
+    std::cout << "test_case003 " << hits << " hits, hit rate " << table.hit_rate()
+              << ", failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+// deterministic evaluator which counts its calls
+class counting_evaluator_t : public basic_evaluator_t<9> {
+  public:
+    counting_evaluator_t() : calls(0) {}
+    float evaluate(const basic_playout_t<9> &position, token_t to_move, float *priors) {
+        calls++;
+        for (int i = 0; i < 9 * 9 + 1; ++i)
+            priors[i] = 1.f;
+        const float value = std::tanh(position.score(7.5f) / 10.f);
+        return (to_move == black) ? value : -value;
+    }
+    std::atomic<int> calls;
+};
+
+int test_case004() {
+    // two searches of the same position, once without and once with a table
+    counting_evaluator_t plain, shared;
+    basic_transposition_table_t<9> table(1 << 16);
+
+    basic_mcts_t<9> search(&plain, 2);
+    basic_mcts_t<9> cached(&shared, 2);
+    cached.set_transposition_table(&table);
+    for (int round = 0; round < 2; ++round) {
+        search.set_position(basic_playout_t<9>(), black);
+        search.search(20000);
+        cached.set_position(basic_playout_t<9>(), black);
+        cached.search(20000);
+    }
+
+    const int failed = (shared.calls >= plain.calls);
+    std::cout << "test_case004 evaluations " << plain.calls << " without table, " << shared.calls
+              << " with table (hit rate " << table.hit_rate() << ", " << table.replacements()
+              << " replacements), failed " << failed << " vs. 0" << std::endl;
+    return failed;
+}
+
+int main(int argc, char const *argv[]) {
+    int failed = test_case001() + test_case002() + test_case003() + test_case004();
+    std::cout << "failed " << failed << " vs. 0" << std::endl;
+    return 0;
+}
@@ -81,6 +81,11 @@ class TfGoEngine(BaseEngine):
     def __init__(self, name, export_dir):
         super(TfGoEngine, self).__init__(name)
         self.bridge = GTPbridge('bridge', ["gnugo", "--mode", "gtp"], verbose=False)
+        self.komi = 7.5
+        self.bridge.send("komi {}\n".format(self.komi))
+
+        # own copy of the game, kept in sync with the bridge move by move
+        self.position = goplanes.Position()
 
         self.sess = tf.Session(graph=tf.Graph(), config=tf.ConfigProto(allow_soft_placement=True))
         tf.saved_model.loader.load(self.sess, [tag_constants.SERVING], export_dir)
@@ -94,8 +99,21 @@ class TfGoEngine(BaseEngine):
 
     def call_boardsize(self, args=None):
         boardsize = int(args[0])
+        if boardsize != 19:
+            return "? unacceptable size"
+        self.position.clear()
         return self.bridge.send("boardsize {}\n".format(boardsize))
 
+    def call_clear_board(self, args=None):
+        self.position.clear()
+        return self.bridge.send("clear_board\n")
+
+    def call_undo(self, args=None):
+        ans = self.bridge.send("undo\n")
+        if ans.startswith('='):
+            self.position.undo()
+        return ans
+
     def call_genmove(self, args=None):
         color = args[0].upper()
 
@@ -108,16 +126,21 @@ class TfGoEngine(BaseEngine):
         if "resign" in move.lower():
             return "= resign"
 
-        # get current board
-        white_board, black_board = self._get_board()
+        is_white = int(color == 'W')
 
-        # extract features for this board configuration
-        planes = np.zeros((47, 19, 19), dtype=np.int32)
-        goplanes.planes_from_position(white_board, black_board, planes, int(color == 'W'))
-        planes = planes.reshape((1, 47, 19, 19))
+        # extract features for the current position, the network uses the leading planes
+        planes = np.zeros((49, 19, 19), dtype=np.int32)
+        self.position.planes(planes, is_white)
+        num_planes = self.features.get_shape().as_list()[1]
+        planes = planes[:num_planes].reshape((1, num_planes, 19, 19))
         prob = self.sess.run(self.prob, {self.features: planes})[0][0]
 
-        print board2string(white_board, black_board)
+        legal = np.zeros((19, 19), dtype=np.int32)
+        self.position.legal_mask(legal, is_white)
+
+        stones = np.zeros((19, 19), dtype=np.int32)
+        self.position.stones(stones)
+        print board2string(stones)
         print self.bridge.send('showboard\n').replace('=', ' ')
         self._debug(prob, planes)
 
@@ -131,7 +154,7 @@ class TfGoEngine(BaseEngine):
             move_description = tuple2string((x, y))
             p2 = prob[x][y]
 
-            if self._is_legal(color, move_description):
+            if legal[x, y]:
                 found_legal_moves += 1
                 print "%03i:  %s \t(%f)" % (i + 1, move_description, p2)
                 if found_legal_moves == 10:
@@ -141,21 +164,36 @@ class TfGoEngine(BaseEngine):
             x, y = candidates[0][i][0], candidates[0][i][1]
             move_description = tuple2string((x, y))
             p2 = prob[x][y]
-            is_legal = 'legal' if self._is_legal(color, move_description) else 'illegal'
-
-            if is_legal == 'legal':
+            if legal[x, y]:
                 print "tfgo plays", color + " " + move_description
                 self.bridge.send("play {} {}\n".format(color, move_description))
+                self.position.play(x, y, is_white)
                 return "= " + move_description
 
         return ""
 
+    def call_komi(self, args=None):
+        self.komi = float(args[0])
+        return self.bridge.send("komi {}\n".format(self.komi))
+
     def call_final_score(self, args=None):
-        return self.bridge.send("final_score\n")
+        # area score (Tromp-Taylor) of the current position, all stones count as alive
+        stones = np.zeros((19, 19), dtype=np.int32)
+        self.position.stones(stones)
+        white_board = (stones < 0).astype(np.int32)
+        black_board = (stones > 0).astype(np.int32)
+        ownership = np.zeros((19, 19), dtype=np.int32)
+        score = goplanes.score_from_position(white_board, black_board, ownership, self.komi)
+        if score == 0:
+            return "= 0"
+        return "= %s+%.1f" % ('B' if score > 0 else 'W', abs(score))
 
     def call_play(self, args=None):
         color, move = args
         ans = self.bridge.send("play {} {}\n".format(color, move))
+        if ans.startswith('='):
+            x, y = (-1, -1) if move.lower() == 'pass' else string2tuple(move)
+            self.position.play(x, y, int(color.upper() in ['W', 'WHITE']))
         return ans
 
     def call_quit(self, args=None):
@@ -186,39 +224,6 @@ class TfGoEngine(BaseEngine):
             debug_prob += "\n"
         print(debug_prob + '   ' + "".join(legend_a))
 
-    def _get_board(self):
-        """Return NumPy arrays of the current board configuration.
-
-        Returns:
-            (np.array, np.array): all placed white tokens, all placed black tokens
-        """
-        board = self.call_show_board()
-
-        # regex = r"[0-9]{1,2}([ .+OX]*)[0-9]{1,2}"
-        lines = board.split('\n')[2:-2]
-        lines = [l[3:40].replace('+', '.').replace(' ', '') for l in lines]
-
-        # print lines
-
-        # matches = [re.finditer(regex, l)[0] for l in lines]
-        # matches = [m.group(1).replace('+', '.').replace(' ', '') for m in matches]
-
-        # print matches
-
-        white = np.zeros((19, 19)).astype(np.int32)
-        black = np.zeros((19, 19)).astype(np.int32)
-
-        for x, line in enumerate(lines):
-            for y, tok in enumerate(line):
-                if tok == 'X':
-                    # black[19 - x - 1][y] = 1
-                    black[x, y] = 1
-                if tok == 'O':
-                    # white[19 - x - 1][y] = 1
-                    white[x, y] = 1
-
-        return white, black
-
     def _propose_move(self, color):
         """Propose a move without playing it.
 
@@ -231,21 +236,6 @@ class TfGoEngine(BaseEngine):
         assert color in ['W', 'B']
         return self.bridge.send('gg_genmove {}\n'.format(color))
 
-    def _is_legal(self, color, move_descr):
-        """Check whether a token can be placed at a field.
-
-        Args:
-            color (str): either 'B' or 'W'
-            move_descr : e.g. F7
-
-        Returns:
-            bool: valid move?
-        """
-        assert color in ['W', 'B']
-        ans = self.bridge.send("is_legal {} {}\n".format(color, move_descr))
-        ans = int(clean(ans))
-        return (ans == 1)
-
 
 if __name__ == '__main__':
     eng = TfGoEngine('tfGo', '../../export')
@@ -0,0 +1,43 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# smoke test of goplanes.Position, builds the module in place and checks copies
+
+import os
+import subprocess
+import sys
+
+here = os.path.dirname(os.path.realpath(__file__))
+subprocess.check_call([sys.executable, 'setup.py', 'build_ext', '--inplace'], cwd=here)
+sys.path.insert(0, here)
+
+import goplanes
+import numpy as np
+
+failed = 0
+
+# copy of an empty position (SWIG assigns the returned value)
+empty = goplanes.Position().copy()
+failed += (empty.num_actions() != 0)
+
+p = goplanes.Position()
+for x, y, is_white in [(3, 3, 0), (15, 15, 1), (3, 15, 0), (-1, -1, 1)]:
+    failed += not p.play(x, y, is_white)
+
+q = p.copy()
+failed += (q.hash() != p.hash()) + (q.num_actions() != p.num_actions())
+
+planes_p = np.zeros((49, 19, 19), dtype=np.int32)
+planes_q = np.zeros((49, 19, 19), dtype=np.int32)
+p.planes(planes_p, 0)
+q.planes(planes_q, 0)
+failed += not np.array_equal(planes_p, planes_q)
+
+# the copy is independent of the original
+failed += not q.play(9, 9, 0)
+failed += (p.num_actions() != 4) + (q.num_actions() != 5)
+del p
+failed += (q.num_actions() != 5)
+
+print("Position failed %i vs. 0" % failed)
+sys.exit(failed != 0)
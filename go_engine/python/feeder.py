@@ -0,0 +1,114 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+"""Read minibatches from the shared-memory ring buffer of go_engine/tools/feeder.
+
+Batches are numpy views into the shared memory (no copies). A batch stays valid until the
+next batch is requested, afterwards the slot is handed back to the feeder.
+
+    for planes, labels, labels_2d in SharedBatches('/tfgo_feeder'):
+        sess.run(train_op, {...})
+"""
+
+import mmap
+import os
+import time
+import numpy as np
+
+# byte offsets of feeder_header_t (see tools/feeder.cpp)
+OFFSET_SLOTS = 12
+OFFSET_SLOT_BYTES = 32
+OFFSET_BATCHES = 128
+OFFSET_CONSUMER_STALLS = 192
+OFFSET_CONSUMED = 200
+SEQ_STRIDE = 64
+
+
+class SharedBatches(object):
+    """Zero-copy reader of batches produced by the C++ feeder."""
+    def __init__(self, name='/tfgo_feeder', timeout=60.):
+        path = '/dev/shm/' + name.lstrip('/')
+
+        # wait until the feeder has created and initialized the buffer
+        start = time.time()
+        while True:
+            if os.path.isfile(path) and os.path.getsize(path) > 4096:
+                with open(path, 'rb') as f:
+                    if f.read(8) == b'TFGOFEED':
+                        break
+            if time.time() - start > timeout:
+                raise IOError('feeder %s is not running' % name)
+            time.sleep(0.1)
+
+        self.fd = os.open(path, os.O_RDWR)
+        self.buf = mmap.mmap(self.fd, os.path.getsize(path))
+
+        u32 = np.frombuffer(self.buf, dtype=np.uint32, count=8, offset=8)
+        u64 = np.frombuffer(self.buf, dtype=np.uint64, count=3, offset=32)
+        self.slots = int(u32[1])
+        self.batch_size = int(u32[2])
+        self.symmetries = int(u32[3])
+        self.planes = int(u32[4])
+        self.board = int(u32[5])
+        slot_bytes, data_offset, seq_offset = [int(v) for v in u64]
+
+        self.stats = np.frombuffer(self.buf, dtype=np.uint64, count=10, offset=OFFSET_BATCHES)
+        self.consumer = np.frombuffer(self.buf, dtype=np.uint64, count=2, offset=OFFSET_CONSUMER_STALLS)
+        self.seq = np.frombuffer(self.buf, dtype=np.uint64, count=self.slots * SEQ_STRIDE // 8,
+                                 offset=seq_offset)[::SEQ_STRIDE // 8]
+
+        # numpy views of all slots
+        b, s, p, n = self.batch_size, self.symmetries, self.planes, self.board
+        self.views = []
+        for i in range(self.slots):
+            offset = data_offset + i * slot_bytes
+            planes = np.frombuffer(self.buf, dtype=np.int32, count=b * s * p * n * n, offset=offset)
+            offset += planes.nbytes
+            labels = np.frombuffer(self.buf, dtype=np.int32, count=b * s, offset=offset)
+            offset += labels.nbytes
+            labels_2d = np.frombuffer(self.buf, dtype=np.int32, count=b * s * n * n, offset=offset)
+            self.views.append([planes.reshape((b, s * p, n, n)),
+                               labels.reshape((b, s)),
+                               labels_2d.reshape((b, s, n, n))])
+        self.ticket = 0
+
+    @property
+    def consumer_stalls(self):
+        return int(self.consumer[0])
+
+    def next(self):
+        """Release the previous batch and return the next one."""
+        if self.ticket > 0:
+            previous = self.ticket - 1
+            self.seq[previous % self.slots] = previous + self.slots
+            self.consumer[1] = self.ticket
+
+        slot = self.ticket % self.slots
+        if self.seq[slot] != self.ticket + 1:
+            self.consumer[0] += 1
+            while self.seq[slot] != self.ticket + 1:
+                time.sleep(0.0001)
+
+        self.ticket += 1
+        return self.views[slot]
+
+    __next__ = next
+
+    def __iter__(self):
+        return self
+
+
+if __name__ == '__main__':
+    import argparse
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--shm', help='name of shared memory', default='/tfgo_feeder')
+    parser.add_argument('--batches', help='number of batches to read', type=int, default=1000)
+    args = parser.parse_args()
+
+    reader = SharedBatches(args.shm)
+    start = time.time()
+    for i, (planes, labels, labels_2d) in enumerate(reader):
+        if i + 1 == args.batches:
+            break
+    secs = time.time() - start
+    print('%f batches/s, consumer stalls %i' % (args.batches / secs, reader.consumer_stalls))
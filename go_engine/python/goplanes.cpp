@@ -1,98 +1,23 @@
 // Author: Patrick Wieschollek <mail@patwie.com>
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "../src/token_t.h"
 #include "../src/field_t.h"
 #include "../src/group_t.h"
 #include "../src/board_t.h"
 #include "../src/sgfbin.h"
+#include "../src/replay.h"
+#include "../src/score.h"
+#include "../src/game.h"
+#include "../src/board_batch.h"
 #include "goplanes.h"
 
 
 
 
-int play_game(SGFbin *Game, int* data, const int moves) {
-
-    // GNUgo means: 0 -- all moves
-    // GNUgo means: 1 -- empty board
-    // GNUgo means: 2 -- first move (black)
-
-    // board representation
-    board_t b;
-
-    // properties of ply
-    token_t opponent_player, current_player;
-    int x = 0, y = 0;
-    bool is_white = true, is_move = true, is_pass = true;
-
-    // for (int i = 0; i < 10; ++i)
-    //     Game->debug(i);
-
-    int offset = 0;
-    Game->parse(offset, &x, &y, &is_white, &is_move, &is_pass);
-
-    // place all handicap stones
-    while (!is_move && !is_pass) {
-        // printf("%i: set handicap stone\n", offset);
-        offset++;
-        current_player = is_white ? white : black;
-        opponent_player = is_white ? black : white;
-
-        // convert to GNUgo representation
-        int xx = 0, yy = 0;
-        xx = y;
-        yy = x;
-
-        b.play({xx, yy}, current_player);
-        Game->parse(offset, &x, &y, &is_white, &is_move, &is_pass);
-    }
-
-    // run game for at least 'moves' moves but stop early enough such that a last move remains open
-    int evaluate_until = std::min(offset + moves - 1, (int)Game->num_actions() - 1);
-
-    // really all moves?
-    if(moves == 0)
-        evaluate_until = Game->num_actions();
-
-    for (; offset < evaluate_until; offset++) {
-        // parse move
-        Game->parse(offset, &x, &y, &is_white, &is_move, &is_pass);
-        // Game->debug(offset);
-
-        current_player = is_white ? white : black;
-        opponent_player = is_white ? black : white;
-
-        // convert to GNUgo representation
-        int xx = 0, yy = 0;
-        xx = y;
-        yy = x;
-
-        if (!is_pass) {
-            if (is_move) {
-                b.play({xx, yy}, current_player);
-            } else {
-                b.play({xx, yy}, current_player);
-            }
-        }
-    }
-
-    // given the current situation, we switch to the view of the opponent (the play who's turn it is)
-    b.feature_planes(data, opponent_player);
-
-    // all moves are evaluated nothing to do
-    if(moves == 0)
-        return 0;
-    // parse a next move (the ground-truth)
-    Game->parse(evaluate_until, &x, &y, &is_white, &is_move, &is_pass);
-    int xx = 0, yy = 0;
-    xx = y;
-    yy = x;
-    // std::cout << "next move << "<< xx << " : "<< yy << std::endl;
-    // Game->debug(evaluate_until);
-    const int next_move = 19 * yy + xx;
-    return next_move;
-}
-
-
 /**
  * @brief return board configuration and next move given a file
  * @details SWIG-Python-binding
@@ -139,6 +64,147 @@ int planes_from_bytes(char *bytes, int byteslen,
 }
 
 
+/**
+ * @brief all 49 feature planes plus 8 "liberties after move" planes given a buffer
+ * @details SWIG-Python-binding
+ *
+ * @param bytes buffer of moves
+ * @param byteslen length of buffer
+ * @param data pointer of features (57x19x19, must be zero-initialized)
+ * @param moves number of moves in match to the current position
+ * @return next move on board
+ */
+int extended_planes_from_bytes(char *bytes, int byteslen,
+                               int* data, int dc, int dh, int dw,
+                               int moves) {
+    SGFbin Game((unsigned char*) bytes, byteslen);
+    return play_game_extended(&Game, data, moves);
+}
+
+
+/**
+ * @brief AlphaGo Zero history planes and next move given a buffer
+ * @details SWIG-Python-binding, alternative feature set to planes_from_bytes (see history_t)
+ *
+ * @param bytes buffer of moves
+ * @param byteslen length of buffer
+ * @param data pointer of features (17x19x19, must be zero-initialized)
+ * @param moves number of moves in match to the current position
+ * @return next move on board
+ */
+int history_planes_from_bytes(char *bytes, int byteslen,
+                              int* data, int dc, int dh, int dw,
+                              int moves) {
+    SGFbin Game((unsigned char*) bytes, byteslen);
+    return play_game_history(&Game, data, moves);
+}
+
+
+/**
+ * @brief feature planes and next moves of many games at once (see play_games)
+ * @details SWIG-Python-binding, the games are replayed in lockstep. With ladders the planes
+ *          are the same as planes_from_bytes, without ladders planes 44 and 45 are zero (a
+ *          distinct feature set).
+ *
+ * @param bytes all SGFbin buffers concatenated
+ * @param byteslen length of bytes
+ * @param lengths length of each buffer (one per game)
+ * @param positions number of moves per game in match to the position (as in planes_from_bytes)
+ * @param batch output planes (games x 49 x 19 x 19, completely overwritten)
+ * @param next output next move of each game (as returned by planes_from_bytes)
+ * @param ladders compute the ladder planes (1) or not (0)
+ * @return number of games or -1 if the shapes do not match or a game is invalid
+ */
+int batch_planes_from_bytes(char *bytes, int byteslen, int* lengths, int ln,
+                            int* positions, int pn, int* batch, int bn, int bc, int bh, int bw,
+                            int* next, int nn, int ladders) {
+    if (pn != ln || bn != ln || nn != ln || bc != 49 || bh != 19 || bw != 19)
+        return -1;
+
+    std::vector<std::unique_ptr<SGFbin> > games;
+    std::vector<SGFbin*> pointers;
+    int offset = 0;
+    for (int i = 0; i < ln; ++i) {
+        if (lengths[i] < 0 || offset + lengths[i] > byteslen)
+            return -1;
+        games.emplace_back(new SGFbin((const unsigned char*) bytes + offset, lengths[i], true));
+        // decoding the moves detects invalid records
+        games.back()->moves();
+        if (!games.back()->valid())
+            return -1;
+        pointers.push_back(games.back().get());
+        offset += lengths[i];
+    }
+    return play_games(pointers.data(), ln, positions, batch, next, ladders != 0);
+}
+
+
+/**
+ * @brief number of actions in a SGFbin buffer
+ * @details SWIG-Python-binding, handles headers and compressed move streams
+ *
+ * @param bytes buffer of SGFbin file
+ * @param byteslen length of buffer
+ * @return number of actions (including "set")
+ */
+int num_actions_from_bytes(char *bytes, int byteslen) {
+    SGFbin Game((unsigned char*) bytes, byteslen);
+    return Game.num_actions();
+}
+
+
+/**
+ * @brief decode all actions of a SGFbin buffer at once
+ * @details SWIG-Python-binding, each row of "moves" is [point, color, kind] with
+ *          point = 19 * row + column (-1 for passes), color as token_t (1: white, 2: black)
+ *          and kind as move_t::kind_t (0: set, 1: move, 2: pass)
+ *
+ * @param bytes buffer of SGFbin file
+ * @param byteslen length of buffer
+ * @param moves output array of shape (N, 3), N should be at least num_actions_from_bytes
+ * @return number of actions or -1 if the game is invalid
+ */
+int moves_from_bytes(char *bytes, int byteslen, int* moves, int mm, int mn) {
+    SGFbin Game((unsigned char*) bytes, byteslen);
+    const std::vector<move_t> &actions = Game.moves();
+    if (!Game.valid() || mn != 3)
+        return -1;
+
+    const int n = std::min((int) actions.size(), mm);
+    for (int i = 0; i < n; ++i) {
+        moves[3 * i + 0] = actions[i].point;
+        moves[3 * i + 1] = actions[i].color;
+        moves[3 * i + 2] = actions[i].kind;
+    }
+    return actions.size();
+}
+
+
+/**
+ * @brief planes, the next k actions and the outcome of a position from a single replay
+ * @details SWIG-Python-binding, see play_game_labels for the layout of next_moves (k, 3)
+ *          and outcome (3,)
+ *
+ * @param bytes buffer of SGFbin file
+ * @param byteslen length of buffer
+ * @param data pointer of features (must be zero-initialized)
+ * @param next_moves output array of shape (k, 3)
+ * @param outcome output array [known, value, margin] for the player to move
+ * @param moves number of moves in match to the current position
+ * @return next move on board (as planes_from_bytes) or -2 for invalid arguments
+ */
+int labels_from_bytes(char *bytes, int byteslen,
+                      int* data, int dc, int dh, int dw,
+                      int* next_moves, int nk, int nn,
+                      int* outcome, int on,
+                      int moves) {
+    if (nn != 3 || on != 3)
+        return -2;
+    SGFbin Game((unsigned char*) bytes, byteslen);
+    return play_game_labels(&Game, data, moves, next_moves, nk, outcome);
+}
+
+
 /**
  * @brief return board configuration and next move given a board position
  * @details SWIG-Python-binding
@@ -172,3 +238,133 @@ void planes_from_position(int* bwhite, int wm, int wn,
     b.feature_planes(data, tok);
 }
 
+
+/**
+ * @brief area score (Tromp-Taylor) of a board position
+ * @details SWIG-Python-binding, all stones count as alive
+ *
+ * @param bwhite 19x19 array with 1's for white
+ * @param bblack 19x19 array with 1's for black
+ * @param ownership output 19x19 array (1: black, -1: white, 0: neutral)
+ * @param komi points of white
+ * @return black points - white points - komi (or 0 for arrays of wrong shape)
+ */
+float score_from_position(int* bwhite, int wm, int wn,
+                          int* bblack, int bm, int bn,
+                          int* ownership, int oh, int ow,
+                          float komi) {
+    if (wm * wn != 19 * 19 || bm * bn != 19 * 19 || oh * ow != 19 * 19)
+        return 0;
+
+    int colors[19 * 19];
+    for (int i = 0; i < 19 * 19; ++i)
+        colors[i] = (bwhite[i] == 1) ? white : ((bblack[i] == 1) ? black : empty);
+    return area_score<19>(colors, komi, ownership);
+}
+
+
+/**
+ * @brief area score (Tromp-Taylor) of the final position of a game
+ * @details SWIG-Python-binding
+ *
+ * @param bytes buffer of SGFbin file
+ * @param byteslen length of buffer
+ * @param ownership output 19x19 array (1: black, -1: white, 0: neutral)
+ * @param komi points of white
+ * @return black points - white points - komi
+ */
+float score_from_bytes(char *bytes, int byteslen, int* ownership, int oh, int ow, float komi) {
+    if (oh * ow != 19 * 19)
+        return 0;
+    SGFbin Game((unsigned char*) bytes, byteslen);
+    return play_game_score(&Game, komi, ownership);
+}
+
+
+/**
+ * @brief territory estimate (Japanese-style) of the final position of a game
+ * @details SWIG-Python-binding, dead stones are prisoners of the opponent (see territory_score)
+ *
+ * @param bytes buffer of SGFbin file
+ * @param byteslen length of buffer
+ * @param dead 19x19 array with 1's for dead stones
+ * @param ownership output 19x19 array (1: black, -1: white, 0: neutral)
+ * @param komi points of white
+ * @return black territory + prisoners - white territory - prisoners - komi
+ */
+float territory_from_bytes(char *bytes, int byteslen, int* dead, int deadh, int deadw,
+                           int* ownership, int oh, int ow, float komi) {
+    if (deadh * deadw != 19 * 19 || oh * ow != 19 * 19)
+        return 0;
+    SGFbin Game((unsigned char*) bytes, byteslen);
+    return play_game_score(&Game, komi, ownership, dead);
+}
+
+
+/**
+ * @brief SWIG-Python-binding of a game in progress
+ * @details Keeps move order, ko and captures, unlike planes_from_position which replays all
+ *          stones in raster order.
+ */
+Position::Position() : game_(new game_t()) {}
+
+Position::Position(const Position &other) : game_(new game_t(*other.game_)) {}
+
+Position& Position::operator=(const Position &other) {
+    if (this != &other)
+        game_.reset(new game_t(*other.game_));
+    return *this;
+}
+
+Position::~Position() {}
+
+void Position::clear() {
+    game_->clear();
+}
+
+bool Position::play(int x, int y, int is_white) {
+    const coord_t pos = (x < 0 || y < 0) ? coord_t(-1, -1) : coord_t(x, y);
+    return game_->play(pos, (is_white == 1) ? white : black);
+}
+
+bool Position::undo() {
+    return game_->undo();
+}
+
+Position Position::copy() const {
+    return Position(*this);
+}
+
+int Position::legal_mask(int* mask, int mh, int mw, int is_white) const {
+    if (mh * mw != 19 * 19)
+        return 0;
+    return game_->legal_mask(mask, (is_white == 1) ? white : black);
+}
+
+void Position::planes(int* data, int dc, int dh, int dw, int is_white) const {
+    if (dc * dh * dw != 49 * 19 * 19)
+        return;
+    game_->planes(data, (is_white == 1) ? white : black);
+}
+
+void Position::stones(int* ownership, int oh, int ow) const {
+    if (oh * ow != 19 * 19)
+        return;
+    for (int x = 0; x < 19; ++x)
+        for (int y = 0; y < 19; ++y) {
+            const token_t tok = game_->board().fields[x][y].token();
+            ownership[19 * x + y] = (tok == black) ? 1 : ((tok == white) ? -1 : 0);
+        }
+}
+
+unsigned long long Position::hash() const {
+    return game_->hash();
+}
+
+int Position::to_move() const {
+    return game_->to_move();
+}
+
+int Position::num_actions() const {
+    return game_->actions().size();
+}
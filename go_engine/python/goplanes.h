@@ -3,9 +3,73 @@
 
 int planes_from_file(char* str, int strlen, int* data, int dc, int dh, int dw, int moves);
 int planes_from_bytes(char *bytes, int byteslen, int* data, int dc, int dh, int dw, int moves);
+int extended_planes_from_bytes(char *bytes, int byteslen, int* data, int dc, int dh, int dw, int moves);
+int history_planes_from_bytes(char *bytes, int byteslen, int* data, int dc, int dh, int dw, int moves);
+int num_actions_from_bytes(char *bytes, int byteslen);
+int moves_from_bytes(char *bytes, int byteslen, int* moves, int mm, int mn);
+int labels_from_bytes(char *bytes, int byteslen, int* data, int dc, int dh, int dw,
+                      int* next_moves, int nk, int nn, int* outcome, int on, int moves);
+int batch_planes_from_bytes(char *bytes, int byteslen, int* lengths, int ln,
+                            int* positions, int pn, int* batch, int bn, int bc, int bh, int bw,
+                            int* next, int nn, int ladders);
 
 void planes_from_position(int* bwhite, int wm, int wn, 
                           int* bblack, int bm, int bn, 
                           int* data, int dc, int dh, int dw, 
                           int is_white);
+
+float score_from_position(int* bwhite, int wm, int wn,
+                          int* bblack, int bm, int bn,
+                          int* ownership, int oh, int ow,
+                          float komi);
+float score_from_bytes(char *bytes, int byteslen, int* ownership, int oh, int ow, float komi);
+float territory_from_bytes(char *bytes, int byteslen, int* dead, int deadh, int deadw,
+                           int* ownership, int oh, int ow, float komi);
+
+#ifndef SWIG
+#include <memory>
+
+template<int N> class basic_game_t;
+#endif
+
+/**
+ * @brief long-lived 19x19 position which is updated move by move (see basic_game_t)
+ * @details SWIG-Python-binding, fields are (x, y) = (row from top, column from left),
+ *          passes are (-1, -1), colors are given as is_white (1: white, 0: black)
+ */
+class Position {
+  public:
+    Position();
+    Position(const Position &other);
+    /* deep copy, SWIG assigns the result of copy() to a default constructed Position */
+    Position& operator=(const Position &other);
+    ~Position();
+
+    /* empty board, black to move */
+    void clear();
+    /* place a stone or pass, false if the move is illegal (nothing changes) */
+    bool play(int x, int y, int is_white);
+    /* take back the last move or pass, false if there is none */
+    bool undo();
+    /* independent copy of this position */
+    Position copy() const;
+
+    /* 19x19 array with 1 for legal moves, returns the number of legal moves */
+    int legal_mask(int* mask, int mh, int mw, int is_white) const;
+    /* 49x19x19 feature planes (see board_t::feature_planes), completely overwritten */
+    void planes(int* data, int dc, int dh, int dw, int is_white) const;
+    /* 19x19 array (1: black, -1: white, 0: empty) */
+    void stones(int* ownership, int oh, int ow) const;
+
+    unsigned long long hash() const;
+    /* player to move (1: white, 2: black) */
+    int to_move() const;
+    /* number of moves and passes so far */
+    int num_actions() const;
+
+  private:
+#ifndef SWIG
+    std::unique_ptr<basic_game_t<19>> game_;
+#endif
+};
 #endif
\ No newline at end of file
@@ -14,6 +14,16 @@
 %apply (char *STRING, int LENGTH) {(char *str, int strlen)}
 %apply (char *STRING, int LENGTH) {(char* bytes, int byteslen)}
 %apply (int* INPLACE_ARRAY3, int DIM1, int DIM2, int DIM3) {(int* data, int dc, int dh, int dw)}
+%apply (int* INPLACE_ARRAY2, int DIM1, int DIM2) {(int* moves, int mm, int mn)}
+%apply (int* INPLACE_ARRAY2, int DIM1, int DIM2) {(int* next_moves, int nk, int nn)}
+%apply (int* INPLACE_ARRAY1, int DIM1) {(int* outcome, int on)}
 %apply (int* INPLACE_ARRAY2, int DIM1, int DIM2) {(int* bblack, int bm, int bn)}
 %apply (int* INPLACE_ARRAY2, int DIM1, int DIM2) {(int* bwhite, int wm, int wn)}
+%apply (int* INPLACE_ARRAY2, int DIM1, int DIM2) {(int* ownership, int oh, int ow)}
+%apply (int* IN_ARRAY2, int DIM1, int DIM2) {(int* dead, int deadh, int deadw)}
+%apply (int* INPLACE_ARRAY2, int DIM1, int DIM2) {(int* mask, int mh, int mw)}
+%apply (int* IN_ARRAY1, int DIM1) {(int* lengths, int ln)}
+%apply (int* IN_ARRAY1, int DIM1) {(int* positions, int pn)}
+%apply (int* INPLACE_ARRAY4, int DIM1, int DIM2, int DIM3, int DIM4) {(int* batch, int bn, int bc, int bh, int bw)}
+%apply (int* INPLACE_ARRAY1, int DIM1) {(int* next, int nn)}
 %include "goplanes.h"
\ No newline at end of file
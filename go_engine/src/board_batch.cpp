@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "hash_t.h"
+#include "onehot.h"
+#include "field_t.h"
+#include "group_t.h"
+#include "board_t.h"
+#include "board_batch.h"
+
+namespace {
+
+const int area = N * N;
+const std::uint16_t no_group = N * N;
+
+/**
+ * @brief neighbors of all points in the same order as board_t::neighbor_fields (-1 if outside)
+ */
+struct neighbor_table_t {
+    int of[N * N][4];
+
+    neighbor_table_t() {
+        for (int x = 0; x < N; ++x)
+            for (int y = 0; y < N; ++y) {
+                int *n = of[map2line(x, y)];
+                n[0] = valid_pos(x - 1) ? map2line(x - 1, y) : -1;
+                n[1] = valid_pos(x + 1) ? map2line(x + 1, y) : -1;
+                n[2] = valid_pos(y - 1) ? map2line(x, y - 1) : -1;
+                n[3] = valid_pos(y + 1) ? map2line(x, y + 1) : -1;
+            }
+    }
+};
+
+const neighbor_table_t neighbors;
+
+inline std::uint64_t zobrist(int p, token_t tok) {
+    return hash_t[tok - 1][p / N][p % N];
+}
+
+inline token_t opponent(token_t tok) {
+    return (tok == white) ? black : white;
+}
+
+}  // namespace
+
+
+board_batch_t::board_batch_t() {
+    for (int l = 0; l < lanes; ++l)
+        clear(l);
+    update();
+}
+
+void board_batch_t::clear(int lane) {
+    for (int p = 0; p < area; ++p) {
+        color_[p][lane] = empty;
+        played_at_[p][lane] = 0;
+    }
+    moves_counter_[lane] = 0;
+    ko_[lane] = -1;
+    hash_[lane] = 0;
+    hash_history_[lane].clear();
+    dirty_[lane] = true;
+}
+
+void board_batch_t::update() {
+    bool any = false;
+    for (int l = 0; l < lanes; ++l)
+        any |= dirty_[l];
+    if (!any)
+        return;
+
+    // every stone starts as its own group
+    for (int p = 0; p < area; ++p)
+        for (int l = 0; l < lanes; ++l)
+            label_[p][l] = color_[p][l] ? p : no_group;
+
+    // propagate the smallest label within connected stones of the same color (all lanes at once)
+    bool changed = true;
+    while (changed) {
+        std::uint16_t delta = 0;
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int i = 0; i < area; ++i) {
+                const int p = (pass == 0) ? i : area - 1 - i;
+                for (int k = 0; k < 4; ++k) {
+                    const int q = neighbors.of[p][k];
+                    if (q < 0)
+                        continue;
+                    for (int l = 0; l < lanes; ++l) {
+                        const std::uint16_t same = (color_[p][l] != 0) & (color_[q][l] == color_[p][l]);
+                        const std::uint16_t candidate = same ? label_[q][l] : label_[p][l];
+                        const std::uint16_t next = std::min(label_[p][l], candidate);
+                        delta |= next ^ label_[p][l];
+                        label_[p][l] = next;
+                    }
+                }
+            }
+        }
+        changed = (delta != 0);
+    }
+
+    // group sizes and liberties (each empty field counts once per adjacent group)
+    memset(liberties_, 0, sizeof(liberties_));
+    memset(size_, 0, sizeof(size_));
+    for (int p = 0; p < area; ++p) {
+        for (int l = 0; l < lanes; ++l)
+            size_[label_[p][l]][l]++;
+
+        std::uint16_t adjacent[4][lanes];
+        for (int k = 0; k < 4; ++k) {
+            const int q = neighbors.of[p][k];
+            for (int l = 0; l < lanes; ++l)
+                adjacent[k][l] = (q < 0) ? no_group : label_[q][l];
+        }
+        for (int l = 0; l < lanes; ++l) {
+            if (color_[p][l] != empty)
+                continue;
+            const std::uint16_t a = adjacent[0][l], b = adjacent[1][l];
+            const std::uint16_t c = adjacent[2][l], d = adjacent[3][l];
+            liberties_[a][l]++;
+            liberties_[b][l] += (b != a);
+            liberties_[c][l] += (c != a) & (c != b);
+            liberties_[d][l] += (d != a) & (d != b) & (d != c);
+        }
+    }
+
+    for (int l = 0; l < lanes; ++l)
+        dirty_[l] = false;
+}
+
+bool board_batch_t::legal(int lane, int p, token_t tok) const {
+    if (color_[p][lane] != empty || ko_[lane] == p)
+        return false;
+    if (contains(hash_history_[lane], hash_[lane] ^ zobrist(p, tok)))
+        return false;
+
+    // suicide: no empty neighbor, no capture and all own neighbor groups lose their last liberty
+    const token_t other = opponent(tok);
+    for (int k = 0; k < 4; ++k) {
+        const int q = neighbors.of[p][k];
+        if (q < 0)
+            continue;
+        const token_t c = (token_t) color_[q][lane];
+        const int libs = liberties_[label_[q][lane]][lane];
+        if (c == empty || (c == other && libs == 1) || (c == tok && libs > 1))
+            return true;
+    }
+    return false;
+}
+
+bool board_batch_t::is_legal(int lane, coord_t pos, token_t tok) {
+    if (!valid_pos(pos.first) || !valid_pos(pos.second))
+        return false;
+    if (dirty_[lane])
+        update();
+    return legal(lane, map2line(pos.first, pos.second), tok);
+}
+
+void board_batch_t::remove_group(int lane, int label) {
+    for (int p = label; p < area; ++p)
+        if (label_[p][lane] == label && color_[p][lane] != empty) {
+            color_[p][lane] = empty;
+            played_at_[p][lane] = 0;
+        }
+}
+
+bool board_batch_t::play(int lane, coord_t pos, token_t tok) {
+    if (!is_legal(lane, pos, tok))
+        return false;
+    const int p = map2line(pos.first, pos.second);
+    const token_t other = opponent(tok);
+
+    ko_[lane] = -1;
+    color_[p][lane] = tok;
+    played_at_[p][lane] = moves_counter_[lane]++;
+
+    // remove opponent groups whose last liberty was p
+    int captured[4];
+    int num_captured = 0;
+    for (int k = 0; k < 4; ++k) {
+        const int q = neighbors.of[p][k];
+        if (q < 0 || color_[q][lane] != other)
+            continue;
+        const int g = label_[q][lane];
+        if (liberties_[g][lane] != 1 || std::find(captured, captured + num_captured, g) != captured + num_captured)
+            continue;
+        captured[num_captured++] = g;
+        if (size_[g][lane] == 1)
+            ko_[lane] = q;
+        remove_group(lane, g);
+    }
+
+    hash_[lane] ^= zobrist(p, tok);
+    hash_history_[lane].insert(hash_[lane]);
+    dirty_[lane] = true;
+    return true;
+}
+
+void board_batch_t::feature_planes(int *planes, const token_t *self, int num_lanes) {
+    update();
+
+    // per-point values of all lanes ([point][lane])
+    std::int32_t (&values)[5][N * N][lanes] = values_;
+    std::uint8_t (&binary)[4][N * N][lanes] = binary_;
+    enum { since, own_liberties, opponent_liberties, capture_size, self_atari_size };
+    enum { sensible, own, opponent_stone, free_field };
+
+    for (int p = 0; p < area; ++p) {
+        for (int l = 0; l < num_lanes; ++l) {
+            const token_t c = (token_t) color_[p][l];
+            const token_t me = self[l];
+            const int libs = liberties_[label_[p][l]][l];
+            values[since][p][l] = (c != empty) ? moves_counter_[l] - played_at_[p][l] + 1 : 0;
+            values[own_liberties][p][l] = (c == me) ? libs : 0;
+            values[opponent_liberties][p][l] = (c != empty && c != me) ? libs : 0;
+            binary[own][p][l] = (c == me);
+            binary[opponent_stone][p][l] = (c != empty && c != me);
+            binary[free_field][p][l] = (c == empty);
+        }
+
+        // probes of empty fields (legality, captures, eyes) differ per lane
+        for (int l = 0; l < num_lanes; ++l) {
+            values[capture_size][p][l] = 0;
+            values[self_atari_size][p][l] = 0;
+            binary[sensible][p][l] = 0;
+            if (color_[p][l] != empty || !legal(l, p, self[l]))
+                continue;
+
+            const token_t me = self[l];
+            int groups[4];
+            int num_groups = 0;
+            int capture = 0, merged = 1;
+            bool has_liberty = false, eye = true;
+            for (int k = 0; k < 4; ++k) {
+                const int q = neighbors.of[p][k];
+                if (q < 0)
+                    continue;
+                const token_t c = (token_t) color_[q][l];
+                eye &= (c == me);
+                if (c == empty) {
+                    has_liberty = true;
+                    continue;
+                }
+                const int g = label_[q][l];
+                if (std::find(groups, groups + num_groups, g) != groups + num_groups)
+                    continue;
+                groups[num_groups++] = g;
+                if (c == me) {
+                    merged += size_[g][l];
+                    has_liberty |= liberties_[g][l] > 1;
+                } else if (liberties_[g][l] == 1) {
+                    capture += size_[g][l];
+                }
+            }
+            values[capture_size][p][l] = capture;
+            // own neighbors without any other liberty are counted including the new stone
+            values[self_atari_size][p][l] = (!has_liberty && merged > 1) ? merged : 0;
+            binary[sensible][p][l] = !eye;
+        }
+    }
+
+    // transpose into the plane layout of each lane
+    const int first_plane[5] = {4, 12, 20, 28, 36};
+    const int binary_plane[4] = {46, 0, 1, 2};
+    int compact[N * N];
+    for (int l = 0; l < num_lanes; ++l) {
+        int *out = planes + l * 49 * area;
+        std::fill(out, out + 49 * area, 0);
+
+        for (int v = 0; v < 5; ++v) {
+            for (int p = 0; p < area; ++p)
+                compact[p] = values[v][p][l];
+            one_hot_planes(compact, out + first_plane[v] * area, area);
+        }
+        for (int b = 0; b < 4; ++b)
+            for (int p = 0; p < area; ++p)
+                out[binary_plane[b] * area + p] = binary[b][p][l];
+
+        const int is_black = (self[l] == black) ? 1 : 0;
+        for (int p = 0; p < area; ++p) {
+            out[3 * area + p] = 1;
+            out[48 * area + p] = is_black;
+        }
+    }
+}
+
+
+int play_games(SGFbin **games, int num_games, const int *moves, int *data, int *next_moves,
+               bool ladders) {
+    const int lanes = board_batch_t::lanes;
+    board_batch_t batch;
+
+    for (int first = 0; first < num_games; first += lanes) {
+        const int num_lanes = std::min(lanes, num_games - first);
+
+        // same positions as play_game
+        std::vector<const std::vector<move_t>*> actions(num_lanes);
+        int until[lanes];
+        token_t to_move[lanes];
+        int longest = 0;
+        for (int l = 0; l < lanes; ++l) {
+            batch.clear(l);
+            to_move[l] = black;
+            until[l] = 0;
+            if (l >= num_lanes)
+                continue;
+
+            actions[l] = &games[first + l]->moves();
+            const int num_actions = actions[l]->size();
+            const int m = moves[first + l];
+            int offset = 0;
+            while (offset < num_actions && (*actions[l])[offset].kind == move_t::set)
+                offset++;
+            until[l] = (m == 0) ? num_actions : std::min(offset + m - 1, num_actions - 1);
+            longest = std::max(longest, until[l]);
+        }
+
+        // advance all games in lockstep
+        for (int step = 0; step < longest; ++step) {
+            for (int l = 0; l < num_lanes; ++l) {
+                if (step >= until[l])
+                    continue;
+                const move_t &m = (*actions[l])[step];
+                to_move[l] = opponent(m.player());
+                if (m.kind != move_t::pass)
+                    batch.play(l, {m.row(), m.col()}, m.player());
+            }
+            batch.update();
+        }
+
+        batch.feature_planes(data + first * 49 * area, to_move, num_lanes);
+
+        // ladder reads need the tree search of board_t, replay each game once more
+        for (int l = 0; ladders && l < num_lanes; ++l) {
+            board_t b;
+            for (int step = 0; step < until[l]; ++step) {
+                const move_t &m = (*actions[l])[step];
+                if (m.kind != move_t::pass)
+                    b.play({m.row(), m.col()}, m.player());
+            }
+            int *out = data + (first + l) * 49 * area;
+            for (int h = 0; h < N; ++h)
+                for (int w = 0; w < N; ++w) {
+                    if (b.fields[h][w].token() != empty)
+                        continue;
+                    out[map3line(44, h, w)] = b.is_forced_ladder_capture({h, w}, to_move[l]);
+                    out[map3line(45, h, w)] = b.is_forced_ladder_escape({h, w}, to_move[l]);
+                }
+        }
+
+        for (int l = 0; l < num_lanes; ++l) {
+            const int num_actions = actions[l]->size();
+            int next = -1;
+            if (moves[first + l] == 0)
+                next = 0;
+            else if (until[l] >= 0 && until[l] < num_actions) {
+                const move_t &m = (*actions[l])[until[l]];
+                next = (m.kind == move_t::pass) ? 0 : 19 * m.col() + m.row();
+            }
+            next_moves[first + l] = next;
+        }
+    }
+    return num_games;
+}
@@ -0,0 +1,112 @@
+#ifndef ENGINE_BOARD_BATCH_H
+#define ENGINE_BOARD_BATCH_H
+
+#include <cstdint>
+#include <set>
+#include <utility>
+
+#include "misc.h"
+#include "token_t.h"
+#include "sgfbin.h"
+
+/**
+ * @brief Several independent boards advanced in lockstep (structure of arrays across games)
+ * @details All per-point state is stored as [point][lane], such that the loops over the lanes
+ *          of a point (group labelling, liberty counting, feature values) are contiguous and
+ *          vectorized by the compiler. Moves are applied per lane, then update() recomputes
+ *          groups and liberties of all lanes at once by label propagation.
+ *
+ *          The rules are the same as in board_t: a move is illegal on an occupied field, on the
+ *          field of the last captured single stone (ko), if the position hash was seen before
+ *          (super-ko, the hash covers all stones ever placed) or if it is a suicide.
+ *
+ *          The feature planes match board_t::feature_planes except for the ladder planes
+ *          (44, 45), which need a tree search per field and are left at zero.
+ */
+class board_batch_t {
+  public:
+    static const int lanes = 16;
+
+    board_batch_t();
+
+    /**
+     * @brief empty the board of a lane
+     */
+    void clear(int lane);
+
+    /**
+     * @brief place a stone (same as board_t::play)
+     *
+     * @param lane board to play on
+     * @param pos (x, y) = [vertical axis (top -> bottom), y horizontal axis (left ->right)]
+     * @param tok color of stone
+     * @return false if the move is not legal (nothing changes)
+     */
+    bool play(int lane, coord_t pos, token_t tok);
+
+    /**
+     * @brief test whether placing a token at pos is legal (same as board_t::is_legal)
+     */
+    bool is_legal(int lane, coord_t pos, token_t tok);
+
+    /**
+     * @brief recompute groups, liberties and group sizes of all lanes which changed
+     */
+    void update();
+
+    /**
+     * @brief compute features of all lanes (see board_t::feature_planes)
+     *
+     * @param planes lanes x 49 x 19 x 19 values (completely overwritten)
+     * @param self perspective of each lane (num_lanes values)
+     * @param num_lanes only compute the first num_lanes boards
+     */
+    void feature_planes(int *planes, const token_t *self, int num_lanes = lanes);
+
+  private:
+    bool legal(int lane, int p, token_t tok) const;
+    void remove_group(int lane, int label);
+
+    /* stone colors */
+    std::uint8_t color_[N * N][lanes];
+    /* move counter when the stone was placed */
+    std::int32_t played_at_[N * N][lanes];
+    /* group of a stone (smallest point of the group), N * N for empty fields */
+    std::uint16_t label_[N * N][lanes];
+    /* liberties and number of stones by group label */
+    std::uint16_t liberties_[N * N + 1][lanes];
+    std::uint16_t size_[N * N + 1][lanes];
+
+    /* feature values ([point][lane]) before they are written into planes */
+    std::int32_t values_[5][N * N][lanes];
+    std::uint8_t binary_[4][N * N][lanes];
+
+    int moves_counter_[lanes];
+    int ko_[lanes];
+    bool dirty_[lanes];
+    std::uint64_t hash_[lanes];
+    std::set<std::uint64_t> hash_history_[lanes];
+};
+
+/**
+ * @brief replay several games in lockstep and compute the feature planes of a position of each
+ * @details Same positions and next moves as play_game, games are processed in batches of
+ *          board_batch_t::lanes.
+ *
+ *          With ladders, the ladder planes (44, 45) are read on a board_t of each game, such
+ *          that the planes equal those of play_game. The ladder reads take most of the time.
+ *          Without ladders, the output is a distinct feature set: the planes of play_game with
+ *          planes 44 and 45 left at zero (a network has to be trained on this set).
+ *
+ * @param games games to replay
+ * @param num_games number of games
+ * @param moves number of moves per game in match to the position (as in play_game)
+ * @param data output planes (num_games x 49 x 19 x 19, completely overwritten)
+ * @param next_moves output next move of each game (as returned by play_game)
+ * @param ladders compute the ladder planes (same planes as play_game)
+ * @return number of games
+ */
+int play_games(SGFbin **games, int num_games, const int *moves, int *data, int *next_moves,
+               bool ladders = true);
+
+#endif
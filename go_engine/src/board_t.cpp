@@ -34,6 +34,8 @@ y  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8
 */
 
 
+#include <algorithm>
+#include <bitset>
 #include <set>
 #include <map>
 #include <iomanip>
@@ -42,10 +44,13 @@ y  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8
 #include "field_t.h"
 #include "group_t.h"
 #include "board_t.h"
+#include "onehot.h"
+#include "thread_pool.h"
 
 
 
-board_t::board_t() : score_black(0.f), score_white(0.f), moves_counter(0), current_hash(0) {
+template<int N>
+basic_board_t<N>::basic_board_t() : score_black(0.f), score_white(0.f), moves_counter(0), current_hash(0) {
     // create all fields with ptr to this board and tell them their position
     for (int h = 0; h < N; ++h){
         std::vector<field_t> row;
@@ -63,7 +68,8 @@ board_t::board_t() : score_black(0.f), score_white(0.f), moves_counter(0), curre
     // we do not maintain the "current_player"
 }
 
-board_t::~board_t() {
+template<int N>
+basic_board_t<N>::~basic_board_t() {
     // proper deletion of groups
     for(auto &g : groups)
         delete g.second;
@@ -71,7 +77,8 @@ board_t::~board_t() {
 
 
 
-std::ostream& operator<< (std::ostream& stream, const board_t& b) {
+template<int N>
+std::ostream& operator<< (std::ostream& stream, const basic_board_t<N>& b) {
     stream << "------ START internal representation ------------------" << std::endl;
     stream << std::endl;
     stream << "            WHITE (O) vs BLACK (X) " << std::endl;
@@ -93,10 +100,10 @@ std::ostream& operator<< (std::ostream& stream, const board_t& b) {
     stream << "   " << "    x " << std::endl;
     
     for (int h = 0; h < N; ++h) {
-        stream << std::setw(2) << (19 - h)  << " ";
+        stream << std::setw(2) << (N - h)  << " ";
         for (int w = 0; w < N; ++w)
             stream  << b.fields[h][w] << " ";
-        stream << std::setw(2) << (19 - h)  << " ";
+        stream << std::setw(2) << (N - h)  << " ";
         stream << "   " << std::setw(2) << (h)  << " ";
         stream << std::endl;
     }
@@ -110,11 +117,12 @@ std::ostream& operator<< (std::ostream& stream, const board_t& b) {
 }
 
 
-group_t* board_t::find_or_create_group(int id){
+template<int N>
+basic_group_t<N>* basic_board_t<N>::find_or_create_group(int id){
     // try to get group by id
-    groups_iter = groups.find(id);
-    if (groups_iter != groups.end()){
-        return groups_iter->second;
+    const auto it = groups.find(id);
+    if (it != groups.end()){
+        return it->second;
     }
     else{
         // group with id does not exists --> create a new group with that id
@@ -124,7 +132,8 @@ group_t* board_t::find_or_create_group(int id){
 }
 
 
-board_t* board_t::clone() const {
+template<int N>
+basic_board_t<N>* basic_board_t<N>::clone() const {
     // a deep clone
 
     board_t* dest = new board_t();
@@ -153,12 +162,15 @@ board_t* board_t::clone() const {
     dest->current_hash = current_hash;
     dest->hash_history = hash_history;
     dest->ko = ko;
+    dest->score_black = score_black;
+    dest->score_white = score_white;
     return dest;
 }
 
 
 
-bool board_t::play(coord_t pos, token_t tok) {
+template<int N>
+bool basic_board_t<N>::play(coord_t pos, token_t tok) {
     const int x = pos.first;
     const int y = pos.second;
 
@@ -207,14 +219,16 @@ bool board_t::play(coord_t pos, token_t tok) {
     return true;
 }
 
-const field_t* board_t::field(coord_t pos) const{
+template<int N>
+const basic_field_t<N>* basic_board_t<N>::field(coord_t pos) const{
     return &fields[pos.first][pos.second];
 }
 
 
-bool board_t::is_forced_ladder_capture(coord_t capture_effort,
+template<int N>
+bool basic_board_t<N>::is_forced_ladder_capture(coord_t capture_effort,
                                 token_t hunter_player,
-                                int recursion_depth, group_t* focus) const{
+                                int recursion_depth, const group_t* focus) const{
 
     const token_t defender_player = opponent(hunter_player);
 
@@ -227,7 +241,7 @@ bool board_t::is_forced_ladder_capture(coord_t capture_effort,
         return true;
 
     // collect all fields that might be a defender_player of a ladder capture
-    std::set<group_t *> groups_to_check;
+    std::set<const group_t *> groups_to_check;
 
     // called with default args (no particular focus?)
     if(focus == nullptr){
@@ -284,7 +298,8 @@ bool board_t::is_forced_ladder_capture(coord_t capture_effort,
     return false;
 }
 
-std::uint64_t board_t::rehash(coord_t pos, token_t player) const{
+template<int N>
+std::uint64_t basic_board_t<N>::rehash(coord_t pos, token_t player) const{
     if(player == empty)
         return current_hash;
     const int x = pos.first;
@@ -295,7 +310,8 @@ std::uint64_t board_t::rehash(coord_t pos, token_t player) const{
     return current_hash^lut_entry;
 }
 
-const bool board_t::looks_like_an_eye(coord_t pos, token_t player) const{
+template<int N>
+const bool basic_board_t<N>::looks_like_an_eye(coord_t pos, token_t player) const{
     for(auto &&p : neighbor_fields(pos))
         if(field(p)->token() != player )
             return false;
@@ -303,10 +319,11 @@ const bool board_t::looks_like_an_eye(coord_t pos, token_t player) const{
 }
 
 
-bool board_t::is_forced_ladder_escape(coord_t escape_effort_field,
+template<int N>
+bool basic_board_t<N>::is_forced_ladder_escape(coord_t escape_effort_field,
                                token_t hunter_player,
                                int recursion_depth,
-                               group_t* focus)  const{
+                               const group_t* focus)  const{
 
     // too many recursion
     if(recursion_depth > 100)
@@ -320,7 +337,7 @@ bool board_t::is_forced_ladder_escape(coord_t escape_effort_field,
         return false;
     
     // these groups might help to escape from the current threat
-    std::set<group_t *> groups_to_check;
+    std::set<const group_t *> groups_to_check;
 
     if(focus == nullptr){
         // try to find all groups which belong to a ladder
@@ -393,7 +410,8 @@ bool board_t::is_forced_ladder_escape(coord_t escape_effort_field,
 
 }
 
- const std::vector<coord_t > board_t::neighbor_fields(coord_t pos) const {
+template<int N>
+ const std::vector<coord_t > basic_board_t<N>::neighbor_fields(coord_t pos) const {
     const int x = pos.first;
     const int y = pos.second;
 
@@ -410,7 +428,8 @@ bool board_t::is_forced_ladder_escape(coord_t escape_effort_field,
 }
 
 
-void board_t::update_groups(coord_t pos) {
+template<int N>
+void basic_board_t<N>::update_groups(coord_t pos) {
     const int x = pos.first;
     const int y = pos.second;
 
@@ -436,11 +455,13 @@ void board_t::update_groups(coord_t pos) {
 
 }
 
-const token_t board_t::opponent(token_t tok) const {
+template<int N>
+const token_t basic_board_t<N>::opponent(token_t tok) const {
     return (tok == white) ? black : white;
 }
 
-bool board_t::is_legal(coord_t pos, token_t tok) const {
+template<int N>
+bool basic_board_t<N>::is_legal(coord_t pos, token_t tok) const {
     const int x = pos.first;
     const int y = pos.second;
 
@@ -472,7 +493,8 @@ bool board_t::is_legal(coord_t pos, token_t tok) const {
 
 }
 
-int board_t::estimate_captured_stones(int x, int y, token_t color_place, token_t color_count)  const {
+template<int N>
+int basic_board_t<N>::estimate_captured_stones(int x, int y, token_t color_place, token_t color_count)  const {
     if (!valid_pos(x) || !valid_pos(y))
         return 0;
 
@@ -491,7 +513,8 @@ int board_t::estimate_captured_stones(int x, int y, token_t color_place, token_t
     return scores;
 }
 
-int board_t::count_and_remove_captured_stones(int x, int y, token_t focus) {
+template<int N>
+int basic_board_t<N>::count_and_remove_captured_stones(int x, int y, token_t focus) {
     int scores = 0;
 
     const auto neighbors = neighbor_fields({x, y});
@@ -514,11 +537,13 @@ int board_t::count_and_remove_captured_stones(int x, int y, token_t focus) {
 }
 
 
-int board_t::liberties(coord_t pos) const{
+template<int N>
+int basic_board_t<N>::liberties(coord_t pos) const{
     return liberties(pos.first, pos.second);
 }
 
-int board_t::liberties(int x, int y) const{
+template<int N>
+int basic_board_t<N>::liberties(int x, int y) const{
     // we keep this version for the features-planes
     if(fields[x][y].token() == empty)
         return 0;
@@ -527,7 +552,13 @@ int board_t::liberties(int x, int y) const{
 
 }
 
-void board_t::feature_planes(int *planes, token_t self) const {
+template<int N>
+void basic_board_t<N>::feature_planes(int *planes, token_t self) const {
+    feature_planes(planes, self, nullptr);
+}
+
+template<int N>
+void basic_board_t<N>::feature_planes(int *planes, token_t self, thread_pool_t *pool) const {
     // see https://gogameguru.com/i/2016/03/deepmind-mastering-go.pdf (Table 2, p. 31)
     /*
     This method assumes we regard the current board from the perspective of "self",
@@ -537,17 +568,32 @@ void board_t::feature_planes(int *planes, token_t self) const {
 
     const token_t other = opponent(self);
 
+    // compact per-point values of the binned features (0 means no plane is set)
+    int turns_since[N * N];
+    int own_liberties[N * N];
+    int opponent_liberties[N * N];
+    int capture_size[N * N];
+    int self_atari_size[N * N];
 
-    for (int h = 0; h < N; ++h) {
+    // a single row of points, rows write disjoint entries of planes and values
+    auto row = [&](int h) {
         for (int w = 0; w < N; ++w) {
+            const int p = map2line(h, w);
+            const token_t tok = fields[h][w].token();
+
+            turns_since[p] = 0;
+            own_liberties[p] = 0;
+            opponent_liberties[p] = 0;
+            capture_size[p] = 0;
+            self_atari_size[p] = 0;
 
             // Stone colour 3
             // 1x mark all fields with own tokens
             // 1x mark all fields with opponent tokens
             // 1x mark all empty fields
-            if (fields[h][w].token() == self)
+            if (tok == self)
                 planes[map3line(0, h, w)] = 1;
-            else if (fields[h][w].token() == other)
+            else if (tok == other)
                 planes[map3line(1, h, w)] = 1;
             else
                 planes[map3line(2, h, w)] = 1;
@@ -556,137 +602,33 @@ void board_t::feature_planes(int *planes, token_t self) const {
             // fill entire plane with ones (mark area to play)
             planes[map3line(3, h, w)] = 1;
 
-            // Turns since
-            // counter number of turns since the token was placed
-            if (fields[h][w].token() != empty) {
-
-                const int since = moves_counter - fields[h][w].played_at + 1;
-
-                if (since == 1)
-                    planes[map3line(4, h, w)] = 1;
-                else if (since == 2)
-                    planes[map3line(5, h, w)] = 1;
-                else if (since == 3)
-                    planes[map3line(6, h, w)] = 1;
-                else if (since == 4)
-                    planes[map3line(7, h, w)] = 1;
-                else if (since == 5)
-                    planes[map3line(8, h, w)] = 1;
-                else if (since == 6)
-                    planes[map3line(9, h, w)] = 1;
-                else if (since == 7)
-                    planes[map3line(10, h, w)] = 1;
-                else if (since > 7)
-                    planes[map3line(11, h, w)] = 1;
-            }
-
-            // Liberties
-            // 8x count number of liberties of own groups
-            if (fields[h][w].token() == self) {
-
-                const int num_liberties = liberties(h, w);
-
-                if (num_liberties == 1)
-                    planes[map3line(12, h, w)] = 1;
-                else if (num_liberties == 2)
-                    planes[map3line(13, h, w)] = 1;
-                else if (num_liberties == 3)
-                    planes[map3line(14, h, w)] = 1;
-                else if (num_liberties == 4)
-                    planes[map3line(15, h, w)] = 1;
-                else if (num_liberties == 5)
-                    planes[map3line(16, h, w)] = 1;
-                else if (num_liberties == 6)
-                    planes[map3line(17, h, w)] = 1;
-                else if (num_liberties == 7)
-                    planes[map3line(18, h, w)] = 1;
-                else if (num_liberties > 7)
-                    planes[map3line(19, h, w)] = 1;
-            }
-
-            // Liberties
-            // 8x count number of liberties of opponent groups
-            if (fields[h][w].token() == other) {
-
-                const int num_liberties = liberties(h, w);
-
-                if (num_liberties == 1)
-                    planes[map3line(20, h, w)] = 1;
-                else if (num_liberties == 2)
-                    planes[map3line(21, h, w)] = 1;
-                else if (num_liberties == 3)
-                    planes[map3line(22, h, w)] = 1;
-                else if (num_liberties == 4)
-                    planes[map3line(23, h, w)] = 1;
-                else if (num_liberties == 5)
-                    planes[map3line(24, h, w)] = 1;
-                else if (num_liberties == 6)
-                    planes[map3line(25, h, w)] = 1;
-                else if (num_liberties == 7)
-                    planes[map3line(26, h, w)] = 1;
-                else if (num_liberties > 7)
-                    planes[map3line(27, h, w)] = 1;
-            }
-
-            // Capture size
-            // 8x How many opponent stones would be captured when playing this field?
-            if (fields[h][w].token() == empty) {
-
-                const int num_capture = estimate_captured_stones(h, w, self, other);
-
-                if (num_capture == 1)
-                    planes[map3line(28, h, w)] = 1;
-                else if (num_capture == 2)
-                    planes[map3line(29, h, w)] = 1;
-                else if (num_capture == 3)
-                    planes[map3line(30, h, w)] = 1;
-                else if (num_capture == 4)
-                    planes[map3line(31, h, w)] = 1;
-                else if (num_capture == 5)
-                    planes[map3line(32, h, w)] = 1;
-                else if (num_capture == 6)
-                    planes[map3line(33, h, w)] = 1;
-                else if (num_capture == 7)
-                    planes[map3line(34, h, w)] = 1;
-                else if (num_capture > 7)
-                    planes[map3line(35, h, w)] = 1;
-            }
-
-            // Self-atari size
-            // 8x How many own stones would be captured when playing this field?
-            if (fields[h][w].token() == empty) {
-
-                const int num_capture = estimate_captured_stones(h, w, self, self);
-
-                if (num_capture == 1)
-                    planes[map3line(36, h, w)] = 1;
-                else if (num_capture == 2)
-                    planes[map3line(37, h, w)] = 1;
-                else if (num_capture == 3)
-                    planes[map3line(38, h, w)] = 1;
-                else if (num_capture == 4)
-                    planes[map3line(39, h, w)] = 1;
-                else if (num_capture == 5)
-                    planes[map3line(40, h, w)] = 1;
-                else if (num_capture == 6)
-                    planes[map3line(41, h, w)] = 1;
-                else if (num_capture == 7)
-                    planes[map3line(42, h, w)] = 1;
-                else if (num_capture > 7)
-                    planes[map3line(43, h, w)] = 1;
-            }
-
-            // Ladder capture : 1 : Whether a move at this point is a successful ladder capture
-            if (fields[h][w].token() == empty) {
-                bool is_ladder_capture = is_forced_ladder_capture({h, w}, self);
-                if(is_ladder_capture)
+            if (tok != empty) {
+                // Turns since
+                // counter number of turns since the token was placed
+                turns_since[p] = moves_counter - fields[h][w].played_at + 1;
+
+                // Liberties
+                // 8x count number of liberties of own groups
+                // 8x count number of liberties of opponent groups
+                if (tok == self)
+                    own_liberties[p] = liberties(h, w);
+                else
+                    opponent_liberties[p] = liberties(h, w);
+            } else {
+                // Capture size
+                // 8x How many opponent stones would be captured when playing this field?
+                capture_size[p] = estimate_captured_stones(h, w, self, other);
+
+                // Self-atari size
+                // 8x How many own stones would be captured when playing this field?
+                self_atari_size[p] = estimate_captured_stones(h, w, self, self);
+
+                // Ladder capture : 1 : Whether a move at this point is a successful ladder capture
+                if (is_forced_ladder_capture({h, w}, self))
                     planes[map3line(44, h, w)] = 1;
-            }
 
-            // Ladder escape : 1 : Whether a move at this point is a successful ladder escape
-            if (fields[h][w].token() == empty) {
-                bool is_ladder_capture = is_forced_ladder_escape({h, w}, self);
-                if(is_ladder_capture)
+                // Ladder escape : 1 : Whether a move at this point is a successful ladder escape
+                if (is_forced_ladder_escape({h, w}, self))
                     planes[map3line(45, h, w)] = 1;
             }
 
@@ -703,6 +645,228 @@ void board_t::feature_planes(int *planes, token_t self) const {
             planes[map3line(48, h, w)] = value;
 
         }
+    };
+
+    if (pool == nullptr) {
+        for (int h = 0; h < N; ++h)
+            row(h);
+    } else {
+        pool->run(N, row);
+    }
+
+    // expand values into the one-hot plane blocks
+    one_hot_planes(turns_since, planes + map3line(4, 0, 0), N * N);
+    one_hot_planes(own_liberties, planes + map3line(12, 0, 0), N * N);
+    one_hot_planes(opponent_liberties, planes + map3line(20, 0, 0), N * N);
+    one_hot_planes(capture_size, planes + map3line(28, 0, 0), N * N);
+    one_hot_planes(self_atari_size, planes + map3line(36, 0, 0), N * N);
+}
+
+template<int N>
+int basic_board_t<N>::count_captured_stones(int x, int y, token_t focus) const {
+    int scores = 0;
+    const group_t *counted[4] = {nullptr, nullptr, nullptr, nullptr};
+    int num_counted = 0;
+
+    for (auto &&n : neighbor_fields({x, y})) {
+        const field_t &other_stone = fields[n.first][n.second];
+        if (other_stone.token() != focus || liberties(n) != 0)
+            continue;
+        // several neighbors might belong to the same group
+        const group_t *g = other_stone.group;
+        if (std::find(counted, counted + num_counted, g) != counted + num_counted)
+            continue;
+        counted[num_counted++] = g;
+        scores += g->stones.size();
+    }
+    return scores;
+}
+
+template<int N>
+void basic_board_t<N>::feature_planes(int *planes, int *opponent_planes, token_t self) const {
+    const token_t players[2] = {self, opponent(self)};
+    int *outputs[2] = {planes, opponent_planes};
+
+    // compact per-point values of the binned features for both perspectives
+    int turns_since[N * N];
+    int liberties_of[2][N * N];
+    int capture_size[2][N * N];
+    int self_atari_size[2][N * N];
+
+    for (int h = 0; h < N; ++h) {
+        for (int w = 0; w < N; ++w) {
+            const int f = map2line(h, w);
+            const token_t tok = fields[h][w].token();
+
+            turns_since[f] = 0;
+            for (int p = 0; p < 2; ++p) {
+                liberties_of[p][f] = 0;
+                capture_size[p][f] = 0;
+                self_atari_size[p][f] = 0;
+            }
+
+            if (tok != empty) {
+                // Stone colour, Turns since, Liberties
+                turns_since[f] = moves_counter - fields[h][w].played_at + 1;
+                liberties_of[(tok == self) ? 0 : 1][f] = liberties(h, w);
+                for (int p = 0; p < 2; ++p)
+                    outputs[p][map3line(((tok == players[p]) ? 0 : 1), h, w)] = 1;
+            } else {
+                for (int p = 0; p < 2; ++p) {
+                    const token_t me = players[p];
+                    int *out = outputs[p];
+                    out[map3line(2, h, w)] = 1;
+
+                    // Capture size and Self-atari size share the legality test and the copy
+                    const bool legal = is_legal({h, w}, me);
+                    if (legal) {
+                        board_t* copy = clone();
+                        copy->fields[h][w].token(me);
+                        copy->update_groups({h, w});
+                        capture_size[p][f] = copy->count_captured_stones(h, w, opponent(me));
+                        self_atari_size[p][f] = copy->count_captured_stones(h, w, me);
+                        delete copy;
+                    }
+
+                    // Ladder capture, Ladder escape
+                    if (is_forced_ladder_capture({h, w}, me))
+                        out[map3line(44, h, w)] = 1;
+                    if (is_forced_ladder_escape({h, w}, me))
+                        out[map3line(45, h, w)] = 1;
+
+                    // Sensibleness
+                    if (legal && !looks_like_an_eye({h, w}, me))
+                        out[map3line(46, h, w)] = 1;
+                }
+            }
+
+            for (int p = 0; p < 2; ++p) {
+                // Ones, Zeros, Player color
+                outputs[p][map3line(3, h, w)] = 1;
+                outputs[p][map3line(47, h, w)] = 0;
+                outputs[p][map3line(48, h, w)] = (players[p] == black) ? 1 : 0;
+            }
+        }
+    }
+
+    // own liberties of one player are the opponent liberties of the other one
+    for (int p = 0; p < 2; ++p) {
+        one_hot_planes(turns_since, outputs[p] + map3line(4, 0, 0), N * N);
+        one_hot_planes(liberties_of[p], outputs[p] + map3line(12, 0, 0), N * N);
+        one_hot_planes(liberties_of[1 - p], outputs[p] + map3line(20, 0, 0), N * N);
+        one_hot_planes(capture_size[p], outputs[p] + map3line(28, 0, 0), N * N);
+        one_hot_planes(self_atari_size[p], outputs[p] + map3line(36, 0, 0), N * N);
+    }
+}
+
+template<int N>
+void basic_board_t<N>::liberties_after_move(int *values, token_t self) const {
+    const int dx[4] = {-1, 0, 1, 0};
+    const int dy[4] = {0, -1, 0, 1};
+
+    // liberties and stones of all groups as bitmasks
+    std::map<const group_t*, int> index;
+    std::vector<std::bitset<N * N> > group_liberties, group_stones;
+    std::vector<token_t> group_color;
+    int group_of[N * N];
+
+    for (int h = 0; h < N; ++h) {
+        for (int w = 0; w < N; ++w) {
+            group_of[map2line(h, w)] = -1;
+            if (fields[h][w].token() == empty)
+                continue;
+            auto it = index.find(fields[h][w].group);
+            if (it == index.end()) {
+                it = index.insert({fields[h][w].group, (int) group_stones.size()}).first;
+                group_liberties.push_back(std::bitset<N * N>());
+                group_stones.push_back(std::bitset<N * N>());
+                group_color.push_back(fields[h][w].token());
+            }
+            const int g = it->second;
+            group_of[map2line(h, w)] = g;
+            group_stones[g].set(map2line(h, w));
+            for (int d = 0; d < 4; ++d) {
+                const int hh = h + dx[d];
+                const int ww = w + dy[d];
+                if (valid_pos(hh) && valid_pos(ww) && fields[hh][ww].token() == empty)
+                    group_liberties[g].set(map2line(hh, ww));
+            }
+        }
+    }
+
+    for (int h = 0; h < N; ++h) {
+        for (int w = 0; w < N; ++w) {
+            const int p = map2line(h, w);
+            values[p] = 0;
+
+            // same tests as is_legal (apart from suicide)
+            if (fields[h][w].token() != empty)
+                continue;
+            if (ko == coord_t(h, w) || contains(hash_history, rehash({h, w}, self)))
+                continue;
+
+            std::bitset<N * N> liberties, stones;
+            stones.set(p);
+            int captured[4];
+            int num_captured = 0;
+
+            for (int d = 0; d < 4; ++d) {
+                const int hh = h + dx[d];
+                const int ww = w + dy[d];
+                if (!valid_pos(hh) || !valid_pos(ww))
+                    continue;
+                const int q = map2line(hh, ww);
+                const int g = group_of[q];
+                if (g < 0) {
+                    liberties.set(q);
+                } else if (group_color[g] == self) {
+                    // merge with own group
+                    liberties |= group_liberties[g];
+                    stones |= group_stones[g];
+                } else if (group_liberties[g].count() == 1) {
+                    // the last liberty of this opponent group is p
+                    if (std::find(captured, captured + num_captured, g) == captured + num_captured)
+                        captured[num_captured++] = g;
+                }
+            }
+            liberties.reset(p);
+
+            // captured stones next to the new group become liberties
+            for (int c = 0; c < num_captured; ++c) {
+                const std::bitset<N * N> &removed = group_stones[captured[c]];
+                for (int q = 0; q < N * N; ++q) {
+                    if (!removed[q])
+                        continue;
+                    const int qh = q / N;
+                    const int qw = q % N;
+                    for (int d = 0; d < 4; ++d) {
+                        const int hh = qh + dx[d];
+                        const int ww = qw + dy[d];
+                        if (valid_pos(hh) && valid_pos(ww) && stones[map2line(hh, ww)]) {
+                            liberties.set(q);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            // suicide is illegal
+            values[p] = liberties.count();
+        }
     }
 }
 
+template<int N>
+void basic_board_t<N>::liberties_after_move_planes(int *planes, token_t self) const {
+    int values[N * N];
+    liberties_after_move(values, self);
+    one_hot_planes(values, planes, N * N);
+}
+
+template class basic_board_t<9>;
+template class basic_board_t<13>;
+template class basic_board_t<19>;
+
+template std::ostream& operator<< (std::ostream& stream, const basic_board_t<9>& b);
+template std::ostream& operator<< (std::ostream& stream, const basic_board_t<13>& b);
+template std::ostream& operator<< (std::ostream& stream, const basic_board_t<19>& b);
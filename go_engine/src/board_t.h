@@ -6,6 +6,7 @@
 #include "misc.h"
 #include "token_t.h"
 #include "field_t.h"
+#include "group_t.h"
 
 #include <array>
 #include <random>
@@ -13,29 +14,41 @@
 #include <vector>
 #include <map>
 
+class thread_pool_t;
+
+
+/**
+ * @brief Go board of size NxN
+ * @details Instantiated for 9x9, 13x13 and 19x19 (see board_t.cpp). Within the board, all index
+ *          helpers of misc.h use the template parameter N, such that the index arithmetic is
+ *          constant-folded for each size. Planes and value arrays have NxN entries per plane.
+ *
+ *          All const methods only read the board (legality tests and ladder reads work on
+ *          clones), hence any number of threads can query the same board concurrently as long
+ *          as no thread modifies it.
+ */
+template<int N>
+class basic_board_t {
+    // the Zobrist table (hash_t.h) covers 19x19 fields, smaller boards use a part of it
+    static_assert(N <= 19, "board size must not exceed 19");
 
-class board_t {
   public:
-    
+    typedef basic_field_t<N> field_t;
+    typedef basic_group_t<N> group_t;
+    typedef basic_board_t<N> board_t;
+
+    static const int size = N;
+
     /**
      * @brief Create new board representation.
      */
-    board_t();
+    basic_board_t();
 
     /**
      * @brief remove all groups
      * @details [long description]
      */
-    ~board_t();
-
-
-    /**
-     * @brief Just for convenience to allow easy outputs.
-     * 
-     * @param stream board configuration
-     * @param b stream
-     */
-    friend std::ostream& operator<< (std::ostream& stream, const board_t& b);
+    ~basic_board_t();
 
     /**
      * @brief Set a stone and update groups.
@@ -109,11 +122,64 @@ class board_t {
      * @brief compute features of current board configuration as an input for the NN
      * @details ust 47 out of the 49 from the Nature paper
      * 
-     * @param planes 47x19x19 values
+     * @param planes 47xNxN values
      * @param self perspective from (predict move for)
      */
     void feature_planes(int *planes, token_t self) const;
 
+    /**
+     * @brief same as above, rows of the board are computed concurrently
+     * @details The per-point work (legality, capture and self-atari probes, ladder reads) is
+     *          split by rows into tasks of pool (see thread_pool_t::run). Every row writes its
+     *          own entries only, hence the planes do not depend on the number of threads.
+     * 
+     * @param planes 49xNxN values (must be zero-initialized)
+     * @param self perspective from (predict move for)
+     * @param pool workers (the calling thread helps), nullptr computes on the calling thread
+     */
+    void feature_planes(int *planes, token_t self, thread_pool_t *pool) const;
+
+    /**
+     * @brief compute features for both players at once
+     * @details Produces exactly the same planes as two calls of feature_planes(planes, tok)
+     *          but shares the colour-independent work (stone colours, turns since, liberties)
+     *          and the legality tests and board copies behind capture size and self-atari.
+     * 
+     * @param planes 49xNxN values from perspective of self (must be zero-initialized)
+     * @param opponent_planes 49xNxN values from perspective of the opponent of self (must be zero-initialized)
+     * @param self perspective of first output
+     */
+    void feature_planes(int *planes, int *opponent_planes, token_t self) const;
+
+    /**
+     * @brief number of liberties of the own group after playing at each empty field
+     * @details This is the "liberties after move" feature of the Nature paper. It is derived
+     *          from the liberties of neighboring groups and the stones of captured groups
+     *          without simulating any move. Illegal moves and occupied fields get 0.
+     * 
+     * @param values NxN values
+     * @param self player who places the stone
+     */
+    void liberties_after_move(int *values, token_t self) const;
+
+    /**
+     * @brief "liberties after move" as 8 planes (1, 2, ..., 7, more than 7)
+     * 
+     * @param planes 8xNxN values (must be zero-initialized)
+     * @param self perspective from (predict move for)
+     */
+    void liberties_after_move_planes(int *planes, token_t self) const;
+
+    /**
+     * @brief count stones of neighboring groups without liberties (does not remove them)
+     * 
+     * @param x
+     * @param y
+     * @param focus just look at groups of this color
+     * @return number of stones which would be removed
+     */
+    int count_captured_stones(int x, int y, token_t focus) const;
+
     /**
      * @brief count liberties from a field
      * @details could benefit from a caching
@@ -158,7 +224,7 @@ class board_t {
     bool is_forced_ladder_escape(coord_t escape_effort,
                            token_t hunter,
                            int recursion_depth=0,
-                           group_t* focus=nullptr) const;
+                           const group_t* focus=nullptr) const;
 
 
     /**
@@ -174,7 +240,7 @@ class board_t {
     bool is_forced_ladder_capture(coord_t capture_effort,
                            token_t hunter,
                            int recursion_depth=0,
-                           group_t* focus=nullptr) const;
+                           const group_t* focus=nullptr) const;
 
 
     /**
@@ -204,8 +270,6 @@ class board_t {
     std::vector<std::vector<field_t> > fields;
     /* representation of groups (connected stones) */
     std::map<int, group_t*> groups;
-    /* iter to find a group */
-    std::map<int, group_t*>::iterator groups_iter;
 
 
     /* helper for unique group ids */
@@ -223,4 +287,15 @@ class board_t {
 
 };
 
+/**
+ * @brief Just for convenience to allow easy outputs.
+ * 
+ * @param stream board configuration
+ * @param b stream
+ */
+template<int N>
+std::ostream& operator<< (std::ostream& stream, const basic_board_t<N>& b);
+
+typedef basic_board_t<19> board_t;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "corpus.h"
+
+namespace {
+
+void collect(const std::string &dir, const std::string &suffix, std::vector<std::string> *files) {
+    DIR *d = opendir(dir.c_str());
+    if (d == nullptr) {
+        std::cerr << "cannot open directory " << dir << std::endl;
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(d)) != nullptr) {
+        const std::string name = entry->d_name;
+        if (name == "." || name == "..")
+            continue;
+        const std::string path = dir + "/" + name;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0)
+            continue;
+        if (S_ISDIR(st.st_mode))
+            collect(path, suffix, files);
+        else if (name.size() > suffix.size() &&
+                 name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+            files->push_back(path);
+    }
+    closedir(d);
+}
+
+std::vector<unsigned char> read_file(const std::string &path) {
+    std::ifstream ifs(path.c_str(), std::ios::binary | std::ios::in);
+    return std::vector<unsigned char>((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+
+SGFcorpus::SGFcorpus(std::string path) {
+    offsets_.push_back(0);
+
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        std::cerr << "cannot read " << path << std::endl;
+        return;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        for (auto &&fn : find_files(path, ".sgfbin")) {
+            std::vector<unsigned char> raw = read_file(fn);
+            add(raw.data(), raw.size());
+        }
+        return;
+    }
+
+    // packed corpus: [uint32 length (little endian)][length bytes] ...
+    std::vector<unsigned char> raw = read_file(path);
+    size_t pos = 0;
+    while (pos + 4 <= raw.size()) {
+        const size_t len = raw[pos] | (raw[pos + 1] << 8) | (raw[pos + 2] << 16) | ((size_t) raw[pos + 3] << 24);
+        pos += 4;
+        if (pos + len > raw.size()) {
+            std::cerr << path << " is truncated" << std::endl;
+            break;
+        }
+        add(raw.data() + pos, len);
+        pos += len;
+    }
+}
+
+void SGFcorpus::add(const unsigned char *buffer, size_t len) {
+    data_.insert(data_.end(), buffer, buffer + len);
+    offsets_.push_back(data_.size());
+}
+
+const size_t SGFcorpus::size() const {
+    return offsets_.size() - 1;
+}
+
+const unsigned char* SGFcorpus::game(size_t i, int *len) const {
+    *len = offsets_[i + 1] - offsets_[i];
+    return data_.data() + offsets_[i];
+}
+
+std::vector<std::string> SGFcorpus::find_files(const std::string &dir, const std::string &suffix) {
+    std::vector<std::string> files;
+    collect(dir, suffix, &files);
+    std::sort(files.begin(), files.end());
+    return files;
+}
@@ -0,0 +1,47 @@
+#ifndef ENGINE_CORPUS_H
+#define ENGINE_CORPUS_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Collection of SGFbin games kept in memory
+ * @details Games are loaded either from a directory tree of *.sgfbin files or from a packed
+ *          corpus written by "sgf2bin --pack" (see docs/FILEFORMAT.md). All games are stored
+ *          in one contiguous buffer.
+ */
+class SGFcorpus {
+  public:
+    /**
+     * @brief load all games from a directory tree or a packed corpus file
+     *
+     * @param path directory or *.sgfpack file
+     */
+    SGFcorpus(std::string path);
+
+    /**
+     * @brief number of games
+     */
+    const size_t size() const;
+
+    /**
+     * @brief raw SGFbin bytes of a game (can be passed to SGFbin(unsigned char*, int))
+     *
+     * @param i index of game
+     * @param len length of buffer
+     */
+    const unsigned char* game(size_t i, int *len) const;
+
+    /**
+     * @brief recursively find all files below a directory with a given suffix (sorted)
+     */
+    static std::vector<std::string> find_files(const std::string &dir, const std::string &suffix);
+
+  private:
+    void add(const unsigned char *buffer, size_t len);
+
+    std::vector<unsigned char> data_;
+    std::vector<size_t> offsets_;
+};
+
+#endif
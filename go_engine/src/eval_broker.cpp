@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <iostream>
+
+#include "eval_broker.h"
+
+
+mock_backend_t::mock_backend_t(int input_size, int output_size, int delay_us)
+    : input_size_(input_size), output_size_(output_size), delay_us_(delay_us) {}
+
+int mock_backend_t::input_size() const {
+    return input_size_;
+}
+
+int mock_backend_t::output_size() const {
+    return output_size_;
+}
+
+void mock_backend_t::evaluate(const float *inputs, int batch, float *outputs) {
+    if (delay_us_ > 0)
+        std::this_thread::sleep_for(std::chrono::microseconds(delay_us_));
+    for (int b = 0; b < batch; ++b) {
+        float sum = 0;
+        for (int i = 0; i < input_size_; ++i)
+            sum += inputs[b * input_size_ + i];
+        for (int j = 0; j < output_size_; ++j)
+            outputs[b * output_size_ + j] = sum + j;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch_sizes_.push_back(batch);
+}
+
+std::vector<int> mock_backend_t::batch_sizes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batch_sizes_;
+}
+
+
+eval_broker_t::eval_broker_t(eval_backend_t *backend, int max_batch, int max_wait_us)
+    : backend_(backend), max_batch_(std::max(1, max_batch)), max_wait_(max_wait_us),
+      stopping_(false), requests_(0), batches_(0) {
+    worker_ = std::thread(&eval_broker_t::run, this);
+}
+
+eval_broker_t::~eval_broker_t() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_one();
+    worker_.join();
+}
+
+std::future<std::vector<float>> eval_broker_t::submit(std::vector<float> input) {
+    request_t request;
+    std::future<std::vector<float>> result = request.promise.get_future();
+    if ((int) input.size() != backend_->input_size()) {
+        std::cerr << "eval_broker_t: input of size " << input.size() << " instead of "
+                  << backend_->input_size() << std::endl;
+        request.promise.set_value(std::vector<float>());
+        return result;
+    }
+    request.input = std::move(input);
+    enqueue(std::move(request));
+    return result;
+}
+
+bool eval_broker_t::submit(std::vector<float> input, callback_t callback) {
+    if ((int) input.size() != backend_->input_size()) {
+        std::cerr << "eval_broker_t: input of size " << input.size() << " instead of "
+                  << backend_->input_size() << std::endl;
+        return false;
+    }
+    request_t request;
+    request.input = std::move(input);
+    request.callback = std::move(callback);
+    enqueue(std::move(request));
+    return true;
+}
+
+void eval_broker_t::enqueue(request_t request) {
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        request.queued = std::chrono::steady_clock::now();
+        queue_.push_back(std::move(request));
+        // the worker sleeps until the first request arrives or the batch is full
+        notify = (queue_.size() == 1 || (int) queue_.size() >= max_batch_);
+    }
+    if (notify)
+        wakeup_.notify_one();
+}
+
+void eval_broker_t::run() {
+    const int in = backend_->input_size();
+    const int out = backend_->output_size();
+    std::vector<float> inputs, outputs;
+    std::vector<request_t> batch;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeup_.wait(lock, [&]() { return stopping_ || !queue_.empty(); });
+            if (queue_.empty())
+                return;
+
+            // wait for a full batch, but not longer than the oldest request allows
+            const auto deadline = queue_.front().queued + max_wait_;
+            wakeup_.wait_until(lock, deadline, [&]() {
+                return stopping_ || (int) queue_.size() >= max_batch_;
+            });
+
+            const int n = std::min((int) queue_.size(), max_batch_);
+            for (int i = 0; i < n; ++i) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+
+        const int n = batch.size();
+        inputs.resize(n * in);
+        outputs.resize(n * out);
+        for (int i = 0; i < n; ++i)
+            std::copy(batch[i].input.begin(), batch[i].input.end(), inputs.begin() + i * in);
+        backend_->evaluate(inputs.data(), n, outputs.data());
+        requests_ += n;
+        batches_++;
+
+        for (int i = 0; i < n; ++i) {
+            std::vector<float> result(outputs.begin() + i * out, outputs.begin() + (i + 1) * out);
+            if (batch[i].callback)
+                batch[i].callback(std::move(result));
+            else
+                batch[i].promise.set_value(std::move(result));
+        }
+        batch.clear();
+    }
+}
+
+std::uint64_t eval_broker_t::requests() const {
+    return requests_;
+}
+
+std::uint64_t eval_broker_t::batches() const {
+    return batches_;
+}
+
+float eval_broker_t::mean_batch_size() const {
+    const std::uint64_t b = batches_;
+    return (b == 0) ? 0.f : (float) requests_ / b;
+}
@@ -0,0 +1,143 @@
+#ifndef ENGINE_EVAL_BROKER_H
+#define ENGINE_EVAL_BROKER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Interface of batched network inference (e.g. a TensorFlow session or a native net)
+ * @details evaluate() is only called by the thread of the broker, it does not need to be
+ *          thread-safe.
+ */
+class eval_backend_t {
+  public:
+    virtual ~eval_backend_t() {}
+
+    /**
+     * @brief number of values of a single input (e.g. 47 * 19 * 19 feature planes)
+     */
+    virtual int input_size() const = 0;
+
+    /**
+     * @brief number of values of a single output (e.g. 19 * 19 move probabilities)
+     */
+    virtual int output_size() const = 0;
+
+    /**
+     * @brief evaluate a batch
+     *
+     * @param inputs batch x input_size() values
+     * @param batch number of inputs
+     * @param outputs batch x output_size() values
+     */
+    virtual void evaluate(const float *inputs, int batch, float *outputs) = 0;
+};
+
+/**
+ * @brief deterministic backend for tests: output j of an input is sum(input) + j
+ * @details Optionally sleeps for a fixed time per batch to mimic an accelerator and records
+ *          the sizes of all batches.
+ */
+class mock_backend_t : public eval_backend_t {
+  public:
+    mock_backend_t(int input_size, int output_size, int delay_us = 0);
+
+    int input_size() const;
+    int output_size() const;
+    void evaluate(const float *inputs, int batch, float *outputs);
+
+    /* sizes of all evaluated batches so far */
+    std::vector<int> batch_sizes() const;
+
+  private:
+    int input_size_;
+    int output_size_;
+    int delay_us_;
+    mutable std::mutex mutex_;
+    std::vector<int> batch_sizes_;
+};
+
+/**
+ * @brief Collects single evaluations of many threads (or games) into batches of a backend
+ * @details A request is queued by submit() and completed by a worker thread of the broker. The
+ *          worker waits until max_batch requests are queued or the oldest queued request waited
+ *          for max_wait, then evaluates up to max_batch requests by a single call of the backend
+ *          and completes their futures or calls their callbacks (on the worker thread).
+ *
+ *          Destroying the broker evaluates all queued requests before the worker stops.
+ */
+class eval_broker_t {
+  public:
+    typedef std::function<void(std::vector<float>)> callback_t;
+
+    /**
+     * @param backend inference implementation (not owned)
+     * @param max_batch largest batch passed to the backend
+     * @param max_wait_us longest time a request waits for a fuller batch (microseconds)
+     */
+    eval_broker_t(eval_backend_t *backend, int max_batch = 16, int max_wait_us = 1000);
+    ~eval_broker_t();
+
+    /**
+     * @brief queue an evaluation
+     *
+     * @param input backend->input_size() values
+     * @return future of the backend->output_size() values (empty for inputs of wrong size)
+     */
+    std::future<std::vector<float>> submit(std::vector<float> input);
+
+    /**
+     * @brief queue an evaluation, callback receives the output on the thread of the broker
+     * @return false if the input has the wrong size (callback is not called)
+     */
+    bool submit(std::vector<float> input, callback_t callback);
+
+    /**
+     * @brief number of evaluated requests
+     */
+    std::uint64_t requests() const;
+
+    /**
+     * @brief number of calls of the backend
+     */
+    std::uint64_t batches() const;
+
+    /**
+     * @brief average number of requests per call of the backend
+     */
+    float mean_batch_size() const;
+
+  private:
+    struct request_t {
+        std::vector<float> input;
+        std::promise<std::vector<float>> promise;
+        callback_t callback;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    void enqueue(request_t request);
+    void run();
+
+    eval_backend_t *backend_;
+    int max_batch_;
+    std::chrono::microseconds max_wait_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::deque<request_t> queue_;
+    bool stopping_;
+
+    std::atomic<std::uint64_t> requests_;
+    std::atomic<std::uint64_t> batches_;
+    std::thread worker_;
+};
+
+#endif
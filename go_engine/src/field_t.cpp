@@ -4,31 +4,39 @@
 #include "board_t.h"
 #include "misc.h"
 
-field_t::field_t(int h, int w, const board_t* b) 
+template<int N>
+basic_field_t<N>::basic_field_t(int h, int w, const board_t* b) 
 : token_(empty), group(nullptr), x_(h), y_(w), played_at(0), board(b) {}
 
-const token_t field_t::token() const {
+template<int N>
+const token_t basic_field_t<N>::token() const {
     return token_;
 }
 
-void field_t::token(const token_t tok) {
+template<int N>
+void basic_field_t<N>::token(const token_t tok) {
     token_ = tok;
 }
 
-void field_t::pos(int x, int y) {
+template<int N>
+void basic_field_t<N>::pos(int x, int y) {
     x_ = x;
     y_ = y;
 }
 
-const int field_t::x() const { return x_;}
-const int field_t::y() const { return y_;}
+template<int N>
+const int basic_field_t<N>::x() const { return x_;}
+template<int N>
+const int basic_field_t<N>::y() const { return y_;}
 
-std::pair<int, int> field_t::pos(){
+template<int N>
+std::pair<int, int> basic_field_t<N>::pos(){
   return {x_, y_};
 }
 
 
-const std::set<std::pair<int, int> > field_t::neighbors(const token_t filter)  const {
+template<int N>
+const std::set<std::pair<int, int> > basic_field_t<N>::neighbors(const token_t filter)  const {
     std::set<std::pair<int, int> > n;
     if(valid_pos(x_ - 1))
         if(board->fields[x_ - 1][y_].token() == filter)
@@ -45,18 +53,14 @@ const std::set<std::pair<int, int> > field_t::neighbors(const token_t filter)  c
     return n;
 }
 
-std::ostream& operator<< (std::ostream& stream, const field_t& stone) {
+template<int N>
+std::ostream& operator<< (std::ostream& stream, const basic_field_t<N>& stone) {
     if (stone.token() == empty){
-        if(   ((stone.x() == 3) && (stone.y() == 3))   ||
-              ((stone.x() == 3) && (stone.y() == 9))   ||
-              ((stone.x() == 3) && (stone.y() == 15))  ||
-              ((stone.x() == 9) && (stone.y() == 3))   ||
-              ((stone.x() == 9) && (stone.y() == 9))   ||
-              ((stone.x() == 9) && (stone.y() == 15))  ||
-              ((stone.x() == 15) && (stone.y() == 3))  ||
-              ((stone.x() == 15) && (stone.y() == 9))  ||
-              ((stone.x() == 15) && (stone.y() == 15)) 
-          ){
+        // star points (3-3 points, or 2-2 points on small boards, sides and center)
+        const int edge = (N < 13) ? 2 : 3;
+        const bool star_x = (stone.x() == edge) || (stone.x() == N / 2) || (stone.x() == N - 1 - edge);
+        const bool star_y = (stone.y() == edge) || (stone.y() == N / 2) || (stone.y() == N - 1 - edge);
+        if(star_x && star_y){
             stream  << "+";
         }
         else{
@@ -68,4 +72,12 @@ std::ostream& operator<< (std::ostream& stream, const field_t& stone) {
     if (stone.token() == black)
         stream  << "x";
     return stream;
-}
\ No newline at end of file
+}
+
+template class basic_field_t<9>;
+template class basic_field_t<13>;
+template class basic_field_t<19>;
+
+template std::ostream& operator<< (std::ostream& stream, const basic_field_t<9>& stone);
+template std::ostream& operator<< (std::ostream& stream, const basic_field_t<13>& stone);
+template std::ostream& operator<< (std::ostream& stream, const basic_field_t<19>& stone);
@@ -10,13 +10,16 @@
 
 #include "token_t.h"
 
-class group_t;
-class board_t;
+template<int N> class basic_group_t;
+template<int N> class basic_board_t;
 
-class field_t {
+template<int N>
+class basic_field_t {
   public:
+    typedef basic_group_t<N> group_t;
+    typedef basic_board_t<N> board_t;
 
-    field_t(int h, int w, const board_t* board);
+    basic_field_t(int h, int w, const board_t* board);
 
     const token_t token() const;
     void token(const token_t tok);
@@ -27,8 +30,6 @@ class field_t {
     const int x() const;
     const int y() const;
 
-    friend std::ostream& operator<< (std::ostream& stream, const field_t& stone);
-
     const std::set<std::pair<int, int> > neighbors(const token_t filter)  const;
 
     group_t* group;
@@ -42,4 +43,9 @@ class field_t {
     const board_t* board;
 };
 
-#endif
\ No newline at end of file
+template<int N>
+std::ostream& operator<< (std::ostream& stream, const basic_field_t<N>& stone);
+
+typedef basic_field_t<19> field_t;
+
+#endif
@@ -0,0 +1,115 @@
+#include <algorithm>
+
+#include "game.h"
+
+
+template<int N>
+basic_game_t<N>::basic_game_t() {
+    clear();
+}
+
+template<int N>
+basic_game_t<N>::basic_game_t(const basic_game_t &other)
+    : board_(other.board_->clone()), actions_(other.actions_), to_move_(other.to_move_),
+      passes_(other.passes_) {}
+
+template<int N>
+basic_game_t<N>& basic_game_t<N>::operator=(const basic_game_t &other) {
+    if (this != &other) {
+        board_.reset(other.board_->clone());
+        actions_ = other.actions_;
+        to_move_ = other.to_move_;
+        passes_ = other.passes_;
+    }
+    return *this;
+}
+
+template<int N>
+void basic_game_t<N>::clear() {
+    board_.reset(new board_t());
+    actions_.clear();
+    to_move_ = black;
+    passes_ = 0;
+}
+
+template<int N>
+bool basic_game_t<N>::play(coord_t pos, token_t tok) {
+    if (tok != white && tok != black)
+        return false;
+
+    if (pos.first < 0) {
+        board_->ko = {-1, -1};
+        passes_++;
+    } else {
+        if (!board_->is_legal(pos, tok) || !board_->play(pos, tok))
+            return false;
+        passes_ = 0;
+    }
+    actions_.push_back({pos, tok});
+    to_move_ = board_->opponent(tok);
+    return true;
+}
+
+template<int N>
+bool basic_game_t<N>::undo() {
+    if (actions_.empty())
+        return false;
+
+    std::vector<std::pair<coord_t, token_t> > replay(actions_.begin(), actions_.end() - 1);
+    clear();
+    for (auto &&action : replay)
+        play(action.first, action.second);
+    return true;
+}
+
+template<int N>
+bool basic_game_t<N>::is_legal(coord_t pos, token_t tok) const {
+    return (pos.first < 0) || board_->is_legal(pos, tok);
+}
+
+template<int N>
+int basic_game_t<N>::legal_mask(int *mask, token_t tok) const {
+    // a legal move leaves at least one liberty, illegal moves get 0 liberties
+    board_->liberties_after_move(mask, tok);
+    int legal = 0;
+    for (int i = 0; i < N * N; ++i) {
+        mask[i] = (mask[i] > 0);
+        legal += mask[i];
+    }
+    return legal;
+}
+
+template<int N>
+void basic_game_t<N>::planes(int *planes, token_t self, thread_pool_t *pool) const {
+    std::fill(planes, planes + 49 * N * N, 0);
+    board_->feature_planes(planes, self, pool);
+}
+
+template<int N>
+std::uint64_t basic_game_t<N>::hash() const {
+    return board_->current_hash;
+}
+
+template<int N>
+token_t basic_game_t<N>::to_move() const {
+    return to_move_;
+}
+
+template<int N>
+int basic_game_t<N>::passes() const {
+    return passes_;
+}
+
+template<int N>
+const std::vector<std::pair<coord_t, token_t> >& basic_game_t<N>::actions() const {
+    return actions_;
+}
+
+template<int N>
+const basic_board_t<N>& basic_game_t<N>::board() const {
+    return *board_;
+}
+
+template class basic_game_t<9>;
+template class basic_game_t<13>;
+template class basic_game_t<19>;
@@ -0,0 +1,100 @@
+#ifndef ENGINE_GAME_H
+#define ENGINE_GAME_H
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "misc.h"
+#include "token_t.h"
+#include "board_t.h"
+
+/**
+ * @brief A game in progress: board, player to move and the actions so far (for undo)
+ * @details Moves and passes alternate the player to move, play() also accepts a move of the
+ *          player who is not to move (as GTP does). A pass lifts the ko. Undo replays all
+ *          remaining actions on a new board, since board_t cannot take back a move.
+ */
+template<int N>
+class basic_game_t {
+  public:
+    typedef basic_board_t<N> board_t;
+
+    basic_game_t();
+    basic_game_t(const basic_game_t &other);
+    basic_game_t& operator=(const basic_game_t &other);
+
+    /**
+     * @brief empty board, black to move
+     */
+    void clear();
+
+    /**
+     * @brief place a stone or pass
+     *
+     * @param pos field or {-1, -1} for a pass
+     * @param tok color of the player
+     * @return false if the move is not legal (nothing changes)
+     */
+    bool play(coord_t pos, token_t tok);
+
+    /**
+     * @brief take back the last action
+     * @return false if there is no action
+     */
+    bool undo();
+
+    /**
+     * @brief test a move (passes are always legal)
+     */
+    bool is_legal(coord_t pos, token_t tok) const;
+
+    /**
+     * @brief legal moves of a player (same result as is_legal, without copying the board)
+     *
+     * @param mask output NxN values (1: legal, 0: illegal)
+     * @param tok player
+     * @return number of legal moves
+     */
+    int legal_mask(int *mask, token_t tok) const;
+
+    /**
+     * @brief feature planes of the position (see board_t::feature_planes)
+     *
+     * @param planes 49xNxN values (completely overwritten)
+     * @param self perspective from, usually to_move()
+     * @param pool computes the rows of the board concurrently if given (same result)
+     */
+    void planes(int *planes, token_t self, thread_pool_t *pool = nullptr) const;
+
+    /**
+     * @brief Zobrist hash of the board (see board_t::rehash)
+     */
+    std::uint64_t hash() const;
+
+    token_t to_move() const;
+
+    /**
+     * @brief number of passes in a row at the end of the game
+     */
+    int passes() const;
+
+    /**
+     * @brief all actions so far ({-1, -1} for passes)
+     */
+    const std::vector<std::pair<coord_t, token_t> >& actions() const;
+
+    const board_t& board() const;
+
+  private:
+    std::unique_ptr<board_t> board_;
+    std::vector<std::pair<coord_t, token_t> > actions_;
+    token_t to_move_;
+    int passes_;
+};
+
+typedef basic_game_t<19> game_t;
+
+#endif
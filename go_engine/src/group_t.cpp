@@ -12,24 +12,29 @@
 
 
 
-group_t::group_t(int groupid, const board_t* b) : board(b){
+template<int N>
+basic_group_t<N>::basic_group_t(int groupid, const board_t* b) : board(b){
     id = groupid;
 }
-group_t::~group_t() {}
+template<int N>
+basic_group_t<N>::~basic_group_t() {}
 
-void group_t::add(field_t *s) {
+template<int N>
+void basic_group_t<N>::add(field_t *s) {
     // add stone to group
     // check (before calling) if stone "s" belongs to opponent group!
     s->group = this;
     stones.push_back(s);
 }
 
-const unsigned int group_t::size() const {
+template<int N>
+const unsigned int basic_group_t<N>::size() const {
     return stones.size();
 }
 
-const std::set<std::pair<int, int> > group_t::neighbors(const token_t filter)  const{
-    std::bitset<19 * 19> already_processed(0);
+template<int N>
+const std::set<std::pair<int, int> > basic_group_t<N>::neighbors(const token_t filter)  const{
+    std::bitset<N * N> already_processed(0);
 
     std::set<std::pair<int, int> > n;
     
@@ -75,7 +80,8 @@ const std::set<std::pair<int, int> > group_t::neighbors(const token_t filter)  c
     return n;
 }
 
-int group_t::kill(board_t *b) {
+template<int N>
+int basic_group_t<N>::kill(board_t *b) {
     // kill entire group (remove stones from board, destroy group, return score)
     int score = stones.size();
     for (field_t * s : stones) {
@@ -88,7 +94,8 @@ int group_t::kill(board_t *b) {
     return score;
 }
 
-void group_t::merge(group_t* other) {
+template<int N>
+void basic_group_t<N>::merge(basic_group_t* other) {
     // never merge a group with itself
     if (other->id == id)
         return;
@@ -102,10 +109,11 @@ void group_t::merge(group_t* other) {
 }
 
 // to avoid circular dependency
-int group_t::liberties() const {
+template<int N>
+int basic_group_t<N>::liberties() const {
     // TODO: this really needs a caching!!!
     // local memory
-    std::bitset<19 * 19> already_processed(0);
+    std::bitset<N * N> already_processed(0);
 
     for (field_t * s : stones) {
 
@@ -136,6 +144,7 @@ int group_t::liberties() const {
     return already_processed.count();
 }
 
-// collection of pointers to stones
-std::vector<field_t *> stones;
-int id;
+template class basic_group_t<9>;
+template class basic_group_t<13>;
+template class basic_group_t<19>;
+
@@ -9,14 +9,17 @@
 
 #include "token_t.h"
 
-class field_t;
-class board_t;
+template<int N> class basic_field_t;
+template<int N> class basic_board_t;
 
-class group_t {
+template<int N>
+class basic_group_t {
   public:
+    typedef basic_field_t<N> field_t;
+    typedef basic_board_t<N> board_t;
 
-    group_t(int groupid, const board_t* board);
-    ~group_t();
+    basic_group_t(int groupid, const board_t* board);
+    ~basic_group_t();
 
     void add(field_t *s);
 
@@ -24,7 +27,7 @@ class group_t {
     const std::set<std::pair<int, int> > neighbors(const token_t filter)  const;
 
     int kill(board_t *b);
-    void merge(group_t* other);
+    void merge(basic_group_t* other);
 
     // count liberties (see below)
     // TODO: cache result (key should be iteration in game)
@@ -36,4 +39,6 @@ class group_t {
     int id;
 };
 
-#endif
\ No newline at end of file
+typedef basic_group_t<19> group_t;
+
+#endif
@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "misc.h"
+#include "game.h"
+#include "score.h"
+#include "gtp_engine.h"
+#include "thread_pool.h"
+
+namespace {
+
+const char *columns = "ABCDEFGHJKLMNOPQRST";
+
+const char *commands[] = {
+    "protocol_version", "name", "version", "known_command", "list_commands", "quit",
+    "boardsize", "clear_board", "komi", "play", "genmove", "undo", "showboard", "final_score"
+};
+
+bool parse_color(std::string s, token_t *tok) {
+    std::transform(s.begin(), s.end(), s.begin(), ::tolower);
+    if (s == "b" || s == "black")
+        *tok = black;
+    else if (s == "w" || s == "white")
+        *tok = white;
+    else
+        return false;
+    return true;
+}
+
+/**
+ * @brief "D4" -> (size - 4, 3), "pass" -> (-1, -1)
+ */
+bool parse_vertex(std::string s, int size, coord_t *pos) {
+    std::transform(s.begin(), s.end(), s.begin(), ::toupper);
+    if (s == "PASS") {
+        *pos = {-1, -1};
+        return true;
+    }
+    if (s.size() < 2)
+        return false;
+    const char *column = std::find(columns, columns + size, s[0]);
+    if (column == columns + size)
+        return false;
+    int row = 0;
+    for (size_t i = 1; i < s.size(); ++i) {
+        if (!std::isdigit(s[i]))
+            return false;
+        row = 10 * row + (s[i] - '0');
+    }
+    if (row < 1 || row > size)
+        return false;
+    *pos = {size - row, (int) (column - columns)};
+    return true;
+}
+
+std::string vertex(coord_t pos, int size) {
+    if (pos.first < 0)
+        return "pass";
+    std::ostringstream s;
+    s << columns[pos.second] << (size - pos.first);
+    return s.str();
+}
+
+}  // namespace
+
+
+/**
+ * @brief a game of any supported size behind a common interface
+ */
+class gtp_engine_t::game_interface_t {
+  public:
+    virtual ~game_interface_t() {}
+    virtual int size() const = 0;
+    virtual bool play(coord_t pos, token_t tok) = 0;
+    virtual bool undo() = 0;
+    virtual token_t token(coord_t pos) const = 0;
+    virtual bool looks_like_an_eye(coord_t pos, token_t tok) const = 0;
+    virtual int legal_mask(int *mask, token_t tok) const = 0;
+    virtual void planes(int *planes, token_t self, thread_pool_t *pool) const = 0;
+    virtual float score(float komi) const = 0;
+};
+
+template<int N>
+class gtp_engine_t::game_adapter_t : public gtp_engine_t::game_interface_t {
+  public:
+    int size() const { return N; }
+    bool play(coord_t pos, token_t tok) { return game.play(pos, tok); }
+    bool undo() { return game.undo(); }
+    token_t token(coord_t pos) const { return game.board().fields[pos.first][pos.second].token(); }
+    bool looks_like_an_eye(coord_t pos, token_t tok) const { return game.board().looks_like_an_eye(pos, tok); }
+    int legal_mask(int *mask, token_t tok) const { return game.legal_mask(mask, tok); }
+    void planes(int *planes, token_t self, thread_pool_t *pool) const { game.planes(planes, self, pool); }
+    float score(float komi) const { return area_score(game.board(), komi); }
+
+    basic_game_t<N> game;
+};
+
+gtp_engine_t::game_interface_t* gtp_engine_t::new_game(int size) {
+    switch (size) {
+        case 9: return new game_adapter_t<9>();
+        case 13: return new game_adapter_t<13>();
+        case 19: return new game_adapter_t<19>();
+        default: return nullptr;
+    }
+}
+
+
+gtp_random_policy_t::gtp_random_policy_t(std::uint64_t seed) : state_(seed ? seed : 1) {}
+
+void gtp_random_policy_t::evaluate(const int *, int size, token_t, float *scores) {
+    for (int i = 0; i < size * size; ++i) {
+        // xorshift64
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        scores[i] = (state_ >> 40) / (float) (1 << 24);
+    }
+}
+
+
+gtp_engine_t::gtp_engine_t(gtp_policy_t *policy, const std::string &name)
+    : policy_(policy), name_(name), game_(new_game(19)), komi_(7.5f), finished_(false) {
+    if (policy_ == nullptr) {
+        own_policy_.reset(new gtp_random_policy_t());
+        policy_ = own_policy_.get();
+    }
+}
+
+gtp_engine_t::~gtp_engine_t() {}
+
+bool gtp_engine_t::finished() const {
+    return finished_;
+}
+
+void gtp_engine_t::set_feature_threads(int threads) {
+    // the calling thread helps the workers
+    feature_pool_.reset((threads > 1) ? new thread_pool_t(threads - 1) : nullptr);
+}
+
+std::string gtp_engine_t::execute(const std::string &line) {
+    // remove comments and control characters, tabs become spaces
+    std::string cleaned;
+    for (char c : line) {
+        if (c == '#')
+            break;
+        if (c == '\t')
+            cleaned += ' ';
+        else if (c >= 32 && c != 127)
+            cleaned += c;
+    }
+
+    std::istringstream in(cleaned);
+    std::string id, command;
+    if (!(in >> command))
+        return "";
+    if (std::isdigit(command[0])) {
+        id = command;
+        if (!(in >> command))
+            return "";
+    }
+    std::string args;
+    std::getline(in, args);
+
+    bool ok = true;
+    const std::string result = dispatch(command, args, &ok);
+    return (ok ? "=" : "?") + id + (result.empty() ? "" : " " + result) + "\n\n";
+}
+
+void gtp_engine_t::run(std::istream &in, std::ostream &out) {
+    std::string line;
+    while (!finished_ && std::getline(in, line)) {
+        const std::string response = execute(line);
+        if (!response.empty())
+            out << response << std::flush;
+    }
+}
+
+std::string gtp_engine_t::board() const {
+    const int size = game_->size();
+    std::ostringstream s;
+    s << "   ";
+    for (int y = 0; y < size; ++y)
+        s << columns[y] << " ";
+    s << "\n";
+    for (int x = 0; x < size; ++x) {
+        s << (size - x < 10 ? " " : "") << (size - x) << " ";
+        for (int y = 0; y < size; ++y) {
+            const token_t tok = game_->token({x, y});
+            s << ((tok == black) ? 'X' : ((tok == white) ? 'O' : '.')) << " ";
+        }
+        s << (size - x) << "\n";
+    }
+    s << "   ";
+    for (int y = 0; y < size; ++y)
+        s << columns[y] << " ";
+    return s.str();
+}
+
+std::string gtp_engine_t::dispatch(const std::string &command, const std::string &args, bool *ok) {
+    std::istringstream in(args);
+    const int size = game_->size();
+
+    if (command == "protocol_version")
+        return "2";
+    if (command == "name")
+        return name_;
+    if (command == "version")
+        return "0.0.1";
+    if (command == "known_command") {
+        std::string name;
+        in >> name;
+        const bool known = std::find(std::begin(commands), std::end(commands), name) != std::end(commands);
+        return known ? "true" : "false";
+    }
+    if (command == "list_commands") {
+        std::string list;
+        for (const char *c : commands)
+            list += std::string(list.empty() ? "" : "\n") + c;
+        return list;
+    }
+    if (command == "quit") {
+        finished_ = true;
+        return "";
+    }
+
+    if (command == "boardsize") {
+        int n = 0;
+        in >> n;
+        game_interface_t *game = new_game(n);
+        if (game == nullptr) {
+            *ok = false;
+            return "unacceptable size";
+        }
+        game_.reset(game);
+        return "";
+    }
+    if (command == "clear_board") {
+        game_.reset(new_game(size));
+        return "";
+    }
+    if (command == "komi") {
+        float komi;
+        if (!(in >> komi)) {
+            *ok = false;
+            return "syntax error";
+        }
+        komi_ = komi;
+        return "";
+    }
+
+    if (command == "play") {
+        std::string color, v;
+        token_t tok;
+        coord_t pos;
+        if (!(in >> color >> v) || !parse_color(color, &tok) || !parse_vertex(v, size, &pos)) {
+            *ok = false;
+            return "syntax error";
+        }
+        if (!game_->play(pos, tok)) {
+            *ok = false;
+            return "illegal move";
+        }
+        return "";
+    }
+    if (command == "genmove") {
+        std::string color;
+        token_t tok;
+        if (!(in >> color) || !parse_color(color, &tok)) {
+            *ok = false;
+            return "syntax error";
+        }
+
+        std::vector<int> planes(49 * size * size), mask(size * size);
+        std::vector<float> scores(size * size);
+        game_->legal_mask(mask.data(), tok);
+        game_->planes(planes.data(), tok, feature_pool_.get());
+        policy_->evaluate(planes.data(), size, tok, scores.data());
+
+        coord_t best = {-1, -1};
+        float best_score = 0;
+        for (int p = 0; p < size * size; ++p) {
+            const coord_t pos(p / size, p % size);
+            if (!mask[p] || game_->looks_like_an_eye(pos, tok))
+                continue;
+            if (best.first < 0 || scores[p] > best_score) {
+                best = pos;
+                best_score = scores[p];
+            }
+        }
+        game_->play(best, tok);
+        return vertex(best, size);
+    }
+    if (command == "undo") {
+        if (!game_->undo()) {
+            *ok = false;
+            return "cannot undo";
+        }
+        return "";
+    }
+    if (command == "showboard")
+        return "\n" + board();
+    if (command == "final_score") {
+        const float score = game_->score(komi_);
+        std::ostringstream s;
+        if (score > 0)
+            s << "B+" << score;
+        else if (score < 0)
+            s << "W+" << -score;
+        else
+            s << "0";
+        return s.str();
+    }
+
+    *ok = false;
+    return "unknown command";
+}
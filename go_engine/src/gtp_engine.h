@@ -0,0 +1,107 @@
+#ifndef ENGINE_GTP_ENGINE_H
+#define ENGINE_GTP_ENGINE_H
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "token_t.h"
+
+class thread_pool_t;
+
+/**
+ * @brief Interface of move selection for genmove
+ */
+class gtp_policy_t {
+  public:
+    virtual ~gtp_policy_t() {}
+
+    /**
+     * @brief score all fields of a position
+     *
+     * @param planes 49 x size x size feature planes from the view of to_move
+     * @param size board size
+     * @param to_move player to move
+     * @param scores output size x size values (field x * size + y), the legal move with the
+     *        highest score is played
+     */
+    virtual void evaluate(const int *planes, int size, token_t to_move, float *scores) = 0;
+};
+
+/**
+ * @brief random scores, i.e. uniformly random legal moves
+ */
+class gtp_random_policy_t : public gtp_policy_t {
+  public:
+    explicit gtp_random_policy_t(std::uint64_t seed = 42);
+    void evaluate(const int *planes, int size, token_t to_move, float *scores);
+
+  private:
+    std::uint64_t state_;
+};
+
+/**
+ * @brief Go Text Protocol (version 2) front end which keeps the game state itself
+ * @details The game is a basic_game_t of the current board size (9, 13 or 19), hence legality,
+ *          undo and scoring need no external engine. genmove plays the legal move with the
+ *          highest score of the policy, but never fills a field whose neighbors are all own
+ *          stones (board_t::looks_like_an_eye). Without such a move it passes.
+ *
+ *          Supported commands: protocol_version, name, version, known_command, list_commands,
+ *          quit, boardsize, clear_board, komi, play, genmove, undo, showboard, final_score.
+ */
+class gtp_engine_t {
+  public:
+    /**
+     * @param policy move selection for genmove (not owned), uniformly random if nullptr
+     * @param name answer of the name command
+     */
+    explicit gtp_engine_t(gtp_policy_t *policy = nullptr, const std::string &name = "tfgo");
+    ~gtp_engine_t();
+
+    /**
+     * @brief execute a single command line
+     * @return complete response ("=[id] ...\n\n" or "?[id] ...\n\n"), empty for empty lines
+     */
+    std::string execute(const std::string &line);
+
+    /**
+     * @brief answer commands of in on out until quit or the end of in
+     */
+    void run(std::istream &in, std::ostream &out);
+
+    /**
+     * @brief did the controller send quit?
+     */
+    bool finished() const;
+
+    /**
+     * @brief number of threads which extract the feature planes of genmove
+     * @details More than one thread lowers the latency of a single genmove (see
+     *          board_t::feature_planes), the planes stay the same.
+     */
+    void set_feature_threads(int threads);
+
+    /**
+     * @brief the current board as in showboard
+     */
+    std::string board() const;
+
+  private:
+    class game_interface_t;
+    template<int N> class game_adapter_t;
+    static game_interface_t* new_game(int size);
+
+    std::string dispatch(const std::string &command, const std::string &args, bool *ok);
+
+    gtp_policy_t *policy_;
+    std::unique_ptr<gtp_policy_t> own_policy_;
+    std::string name_;
+    std::unique_ptr<game_interface_t> game_;
+    std::unique_ptr<thread_pool_t> feature_pool_;
+    float komi_;
+    bool finished_;
+};
+
+#endif
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "gtp_server.h"
+
+
+broker_gtp_policy_t::broker_gtp_policy_t(eval_broker_t *broker, int planes)
+    : broker_(broker), planes_(std::min(49, std::max(1, planes))) {}
+
+void broker_gtp_policy_t::evaluate(const int *planes, int size, token_t to_move, float *scores) {
+    if (broker_ == nullptr || size != 19) {
+        fallback_.evaluate(planes, size, to_move, scores);
+        return;
+    }
+    const std::vector<float> output = broker_->submit(
+        std::vector<float>(planes, planes + planes_ * 19 * 19)).get();
+    if (output.size() != 19 * 19) {
+        fallback_.evaluate(planes, size, to_move, scores);
+        return;
+    }
+    std::copy(output.begin(), output.end(), scores);
+}
+
+
+struct gtp_server_t::session_t {
+    session_t(int fd, eval_broker_t *broker, int planes)
+        : fd(fd), policy(broker, planes), engine(&policy), busy(false) {}
+    ~session_t() { close(fd); }
+
+    const int fd;
+    broker_gtp_policy_t policy;
+    gtp_engine_t engine;
+    /* incomplete line (only used by the thread of run) */
+    std::string buffer;
+    /* complete lines not executed yet and whether a worker owns the session (under mutex_) */
+    std::deque<std::string> pending;
+    bool busy;
+};
+
+namespace {
+
+void send_all(int fd, const std::string &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0)
+            return;
+        sent += n;
+    }
+}
+
+}  // namespace
+
+
+gtp_server_t::gtp_server_t(eval_broker_t *broker, int planes, int workers)
+    : broker_(broker), planes_(planes), listen_fd_(-1), commands_(0), pool_(workers) {
+    if (pipe(wakeup_fd_) != 0) {
+        std::cerr << "gtp_server_t: cannot create pipe" << std::endl;
+        wakeup_fd_[0] = wakeup_fd_[1] = -1;
+    }
+}
+
+gtp_server_t::~gtp_server_t() {
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        unlink(path_.c_str());
+    }
+    for (int fd : wakeup_fd_)
+        if (fd >= 0)
+            close(fd);
+}
+
+bool gtp_server_t::listen(const std::string &path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "gtp_server_t: invalid socket path " << path << std::endl;
+        return false;
+    }
+    std::strcpy(address.sun_path, path.c_str());
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cerr << "gtp_server_t: cannot create socket" << std::endl;
+        return false;
+    }
+    unlink(path.c_str());
+    if (bind(fd, (sockaddr*) &address, sizeof(address)) != 0 || ::listen(fd, 64) != 0) {
+        std::cerr << "gtp_server_t: cannot listen on " << path << std::endl;
+        close(fd);
+        return false;
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        unlink(path_.c_str());
+    }
+    listen_fd_ = fd;
+    path_ = path;
+    return true;
+}
+
+void gtp_server_t::run() {
+    if (listen_fd_ < 0 || wakeup_fd_[0] < 0) {
+        std::cerr << "gtp_server_t: not listening" << std::endl;
+        return;
+    }
+
+    std::vector<pollfd> fds;
+    std::vector<std::shared_ptr<session_t>> polled;
+    while (true) {
+        fds.clear();
+        polled.clear();
+        fds.push_back({wakeup_fd_[0], POLLIN, 0});
+        fds.push_back({listen_fd_, POLLIN, 0});
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto &&s : sessions_) {
+                fds.push_back({s.first, POLLIN, 0});
+                polled.push_back(s.second);
+            }
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0)
+            continue;
+
+        if (fds[0].revents) {
+            char c;
+            if (read(wakeup_fd_[0], &c, 1) == 1)
+                break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            const int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd >= 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                sessions_[fd] = std::make_shared<session_t>(fd, broker_, planes_);
+            }
+        }
+
+        for (size_t i = 0; i < polled.size(); ++i) {
+            if (!fds[i + 2].revents || receive(polled[i]))
+                continue;
+            // the session stays alive until its running command finished
+            std::lock_guard<std::mutex> lock(mutex_);
+            sessions_.erase(polled[i]->fd);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &&s : sessions_)
+        shutdown(s.first, SHUT_RDWR);
+    sessions_.clear();
+}
+
+void gtp_server_t::stop() {
+    if (wakeup_fd_[1] >= 0 && write(wakeup_fd_[1], "x", 1) != 1)
+        return;
+}
+
+int gtp_server_t::sessions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.size();
+}
+
+std::uint64_t gtp_server_t::commands() const {
+    return commands_;
+}
+
+bool gtp_server_t::receive(const std::shared_ptr<session_t> &session) {
+    char data[4096];
+    const ssize_t n = read(session->fd, data, sizeof(data));
+    if (n <= 0)
+        return false;
+
+    std::vector<std::string> lines;
+    for (ssize_t i = 0; i < n; ++i) {
+        if (data[i] == '\n') {
+            lines.push_back(session->buffer);
+            session->buffer.clear();
+        } else {
+            session->buffer += data[i];
+        }
+    }
+    if (lines.empty())
+        return true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &&line : lines)
+        session->pending.push_back(std::move(line));
+    if (!session->busy) {
+        session->busy = true;
+        schedule(session);
+    }
+    return true;
+}
+
+void gtp_server_t::schedule(const std::shared_ptr<session_t> &session) {
+    pool_.post([this, session]() { execute(session); });
+}
+
+void gtp_server_t::execute(const std::shared_ptr<session_t> &session) {
+    // only the worker owning the session (busy) touches its engine
+    std::string line;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (session->engine.finished()) {
+            // lines which arrived after quit
+            session->pending.clear();
+            session->busy = false;
+            return;
+        }
+        line = std::move(session->pending.front());
+        session->pending.pop_front();
+    }
+
+    const std::string response = session->engine.execute(line);
+    if (!response.empty()) {
+        commands_++;
+        send_all(session->fd, response);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (session->engine.finished()) {
+        // the thread of run() sees the end of the connection and removes the session
+        session->pending.clear();
+        shutdown(session->fd, SHUT_RDWR);
+    }
+    if (session->pending.empty())
+        session->busy = false;
+    else
+        schedule(session);
+}
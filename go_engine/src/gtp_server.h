@@ -0,0 +1,109 @@
+#ifndef ENGINE_GTP_SERVER_H
+#define ENGINE_GTP_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "eval_broker.h"
+#include "gtp_engine.h"
+#include "thread_pool.h"
+
+/**
+ * @brief genmove scores of 19x19 positions from a shared eval_broker_t
+ * @details The first planes of the feature planes are converted to floats and submitted to the
+ *          broker, hence positions of concurrent games are evaluated in common batches. The
+ *          backend of the broker takes planes x 19 x 19 values and returns 19 x 19 scores.
+ *          Other board sizes (or without broker) get random scores.
+ */
+class broker_gtp_policy_t : public gtp_policy_t {
+  public:
+    /**
+     * @param broker shared evaluation (not owned), nullptr for random moves only
+     * @param planes number of input planes of the backend (at most 49)
+     */
+    broker_gtp_policy_t(eval_broker_t *broker, int planes);
+    void evaluate(const int *planes, int size, token_t to_move, float *scores);
+
+  private:
+    eval_broker_t *broker_;
+    int planes_;
+    gtp_random_policy_t fallback_;
+};
+
+/**
+ * @brief Hosts many independent GTP sessions in one process behind a Unix domain socket
+ * @details Every connection is a session with its own gtp_engine_t (game, board size, komi),
+ *          i.e. a controller talks plain GTP over the socket, e.g. "socat - UNIX:path".
+ *
+ *          A single thread of run() accepts connections and reads command lines. Commands are
+ *          executed on a shared thread_pool_t, where genmove also extracts the feature planes.
+ *          Commands of the same session run one after another in the order they arrived,
+ *          commands of different sessions run concurrently. genmove waits for the shared
+ *          broker, so the number of workers limits the batch size the broker can collect
+ *          (use at least max_batch workers).
+ *
+ *          "quit" answers and closes the session, the server keeps running until stop().
+ */
+class gtp_server_t {
+  public:
+    /**
+     * @param broker shared evaluation for genmove (not owned), nullptr for random moves
+     * @param planes number of input planes of the backend of the broker
+     * @param workers threads which execute commands
+     */
+    gtp_server_t(eval_broker_t *broker, int planes, int workers = 4);
+    ~gtp_server_t();
+
+    /**
+     * @brief create the socket (an existing file at path is replaced)
+     * @return false if the socket cannot be created
+     */
+    bool listen(const std::string &path);
+
+    /**
+     * @brief serve sessions until stop() is called
+     * @details Sessions still open are closed after their running commands finished.
+     */
+    void run();
+
+    /**
+     * @brief let run() return
+     * @details Only writes to a pipe, hence it can be called from any thread and from signal
+     *          handlers.
+     */
+    void stop();
+
+    /**
+     * @brief number of open sessions
+     */
+    int sessions() const;
+
+    /**
+     * @brief number of executed commands of all sessions
+     */
+    std::uint64_t commands() const;
+
+  private:
+    struct session_t;
+
+    bool receive(const std::shared_ptr<session_t> &session);
+    void schedule(const std::shared_ptr<session_t> &session);
+    void execute(const std::shared_ptr<session_t> &session);
+
+    eval_broker_t *broker_;
+    int planes_;
+    std::string path_;
+    int listen_fd_;
+    int wakeup_fd_[2];
+
+    mutable std::mutex mutex_;
+    std::map<int, std::shared_ptr<session_t>> sessions_;
+    std::atomic<std::uint64_t> commands_;
+    thread_pool_t pool_;
+};
+
+#endif
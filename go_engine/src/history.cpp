@@ -0,0 +1,55 @@
+#include "history.h"
+#include "board_t.h"
+
+history_t::history_t() {
+    clear();
+}
+
+void history_t::clear() {
+    head_ = 0;
+    size_ = 0;
+}
+
+void history_t::push(const board_t &b) {
+    head_ = (head_ + 1) % length;
+    size_ = (size_ < length) ? size_ + 1 : length;
+
+    std::bitset<N * N> &black_stones = black_[head_];
+    std::bitset<N * N> &white_stones = white_[head_];
+    black_stones.reset();
+    white_stones.reset();
+    for (int h = 0; h < N; ++h)
+        for (int w = 0; w < N; ++w) {
+            const token_t tok = b.fields[h][w].token();
+            if (tok == black)
+                black_stones.set(map2line(h, w));
+            else if (tok == white)
+                white_stones.set(map2line(h, w));
+        }
+}
+
+const int history_t::size() const {
+    return size_;
+}
+
+const std::bitset<N * N>& history_t::stones(int t, token_t tok) const {
+    const int i = (head_ - t + length) % length;
+    return (tok == black) ? black_[i] : white_[i];
+}
+
+void history_t::feature_planes(int *planes, token_t self) const {
+    const token_t other = (self == black) ? white : black;
+
+    for (int t = 0; t < size_; ++t) {
+        const std::bitset<N * N> &own = stones(t, self);
+        const std::bitset<N * N> &opp = stones(t, other);
+        for (int i = 0; i < N * N; ++i) {
+            planes[t * N * N + i] = own[i];
+            planes[(length + t) * N * N + i] = opp[i];
+        }
+    }
+
+    if (self == black)
+        for (int i = 0; i < N * N; ++i)
+            planes[2 * length * N * N + i] = 1;
+}
@@ -0,0 +1,68 @@
+#ifndef ENGINE_HISTORY_H
+#define ENGINE_HISTORY_H
+
+#include <bitset>
+#include <set>
+#include <utility>
+
+#include "misc.h"
+#include "token_t.h"
+
+template<int N> class basic_board_t;
+typedef basic_board_t<19> board_t;
+
+/**
+ * @brief Ring buffer of the last positions of a game (AlphaGo Zero input features)
+ * @details Every position is stored as two bit-packed masks (black and white stones), such
+ *          that the history planes are available after a single replay. Call push() after each
+ *          action (passes included) to record the new position.
+ *
+ *          The alternative feature set has 2 * length + 1 planes from the perspective of self:
+ *            - plane t:              own stones t actions ago (t = 0 is the current position)
+ *            - plane length + t:     opponent stones t actions ago
+ *            - plane 2 * length:     ones if self is black
+ *          Planes of positions before the start of the game are zero.
+ */
+class history_t {
+  public:
+    static const int length = 8;
+    static const int num_planes = 2 * length + 1;
+
+    history_t();
+
+    /**
+     * @brief record the current position of a board
+     */
+    void push(const board_t &b);
+
+    /**
+     * @brief forget all positions
+     */
+    void clear();
+
+    /**
+     * @brief number of recorded positions (at most length)
+     */
+    const int size() const;
+
+    /**
+     * @brief stones of a player t actions ago
+     */
+    const std::bitset<N * N>& stones(int t, token_t tok) const;
+
+    /**
+     * @brief write history planes
+     *
+     * @param planes 17x19x19 values (must be zero-initialized)
+     * @param self perspective from (predict move for)
+     */
+    void feature_planes(int *planes, token_t self) const;
+
+  private:
+    std::bitset<N * N> black_[length];
+    std::bitset<N * N> white_[length];
+    int head_;
+    int size_;
+};
+
+#endif
@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "mcts.h"
+
+namespace {
+
+inline token_t opponent(token_t tok) {
+    return (tok == white) ? black : white;
+}
+
+inline void atomic_add(std::atomic<float> &target, float value) {
+    float current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {}
+}
+
+/**
+ * @brief 1 (win), -1 (loss) or 0 (draw) of a final position from the view of tok
+ */
+template<int N>
+float outcome(const basic_playout_t<N> &position, token_t tok, float komi) {
+    const float score = position.score(komi);
+    const float value = (score > 0) ? 1.f : ((score < 0) ? -1.f : 0.f);
+    return (tok == black) ? value : -value;
+}
+
+}  // namespace
+
+
+template<int N>
+float basic_uniform_evaluator_t<N>::evaluate(const basic_playout_t<N> &, token_t, float *priors) {
+    for (int i = 0; i < N * N + 1; ++i)
+        priors[i] = 1.f;
+    return 0.f;
+}
+
+template<int N>
+basic_rollout_evaluator_t<N>::basic_rollout_evaluator_t(float komi, std::uint64_t seed)
+    : komi_(komi), seed_(seed) {}
+
+template<int N>
+float basic_rollout_evaluator_t<N>::evaluate(const basic_playout_t<N> &position, token_t to_move, float *priors) {
+    for (int i = 0; i < N * N + 1; ++i)
+        priors[i] = 1.f;
+
+    // every rollout needs its own random numbers
+    basic_playout_t<N> rollout = position;
+    rollout.seed(seed_.fetch_add(0x9e3779b97f4a7c15ULL, std::memory_order_relaxed));
+    rollout.run(to_move);
+    return outcome(rollout, to_move, komi_);
+}
+
+
+template<int N>
+basic_mcts_t<N>::basic_mcts_t(basic_evaluator_t<N> *evaluator, int threads, float c_puct,
+                              float komi, int virtual_loss)
+    : evaluator_(evaluator), threads_(threads), c_puct_(c_puct), komi_(komi),
+      virtual_loss_(virtual_loss), table_(nullptr), root_(nullptr), root_to_move_(black),
+      num_nodes_(0), collisions_(0) {
+    set_position(basic_playout_t<N>(), black);
+}
+
+template<int N>
+basic_mcts_t<N>::~basic_mcts_t() {
+    delete root_;
+}
+
+template<int N>
+void basic_mcts_t<N>::set_transposition_table(basic_transposition_table_t<N> *table) {
+    table_ = table;
+}
+
+template<int N>
+void basic_mcts_t<N>::set_position(const basic_playout_t<N> &position, token_t to_move) {
+    if (table_ != nullptr)
+        table_->new_generation();
+    delete root_;
+    root_ = new node_t();
+    root_position_ = position;
+    root_to_move_ = to_move;
+    num_nodes_ = 1;
+    collisions_ = 0;
+}
+
+template<int N>
+int basic_mcts_t<N>::search(int simulations) {
+    std::atomic<int> started(0), completed(0);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < threads_; ++t)
+        workers.push_back(std::thread([&]() {
+            basic_playout_t<N> position;
+            while (started.fetch_add(1) < simulations) {
+                // collisions do not count as simulation
+                position = root_position_;
+                while (!simulate(position))
+                    position = root_position_;
+                completed++;
+            }
+        }));
+    for (auto &&w : workers)
+        w.join();
+    return completed;
+}
+
+template<int N>
+typename basic_mcts_t<N>::node_t* basic_mcts_t<N>::select(node_t *node) const {
+    const int visits = node->visits.load(std::memory_order_relaxed);
+    const float sqrt_visits = std::sqrt((float) std::max(1, visits));
+    // first play urgency: unvisited children get the value of node from the view of the player to move
+    const float urgency = (visits > 0) ? -node->value_sum.load(std::memory_order_relaxed) / visits : 0.f;
+
+    node_t *best = nullptr;
+    float best_score = -1e9f;
+    for (int i = 0; i < node->num_children; ++i) {
+        node_t *c = &node->children[i];
+        const int n = c->visits.load(std::memory_order_relaxed);
+        const float q = (n > 0) ? c->value_sum.load(std::memory_order_relaxed) / n : urgency;
+        const float score = q + c_puct_ * c->prior * sqrt_visits / (1 + n);
+        if (score > best_score) {
+            best_score = score;
+            best = c;
+        }
+    }
+    return best;
+}
+
+template<int N>
+float basic_mcts_t<N>::expand(node_t *node, const basic_playout_t<N> &position, token_t to_move) {
+    float priors[N * N + 1];
+    float value;
+    if (table_ == nullptr) {
+        value = evaluator_->evaluate(position, to_move, priors);
+    } else {
+        const std::uint64_t key = position.key(to_move);
+        if (!table_->lookup(key, &value, priors)) {
+            value = evaluator_->evaluate(position, to_move, priors);
+            table_->store(key, value, priors);
+        }
+    }
+
+    // legal moves and the pass
+    std::vector<int> moves;
+    float total = 0.f;
+    for (int p = 0; p < N * N; ++p)
+        if (position.is_legal({p / N, p % N}, to_move)) {
+            moves.push_back(p);
+            total += priors[p];
+        }
+    moves.push_back(pass_move);
+    total += priors[pass_move];
+
+    node_t *children = new node_t[moves.size()];
+    for (size_t i = 0; i < moves.size(); ++i) {
+        children[i].move = moves[i];
+        children[i].prior = (total > 0) ? priors[moves[i]] / total : 1.f / moves.size();
+    }
+    node->children = children;
+    node->num_children = moves.size();
+    num_nodes_ += moves.size();
+    node->state.store(expanded, std::memory_order_release);
+    return value;
+}
+
+template<int N>
+bool basic_mcts_t<N>::simulate(basic_playout_t<N> &position) {
+    node_t *path[max_depth + 1];
+    int depth = 0;
+    node_t *node = root_;
+    token_t to_move = root_to_move_;
+    path[depth++] = node;
+
+    // descend with virtual loss
+    while (!position.finished() && depth <= max_depth &&
+           node->state.load(std::memory_order_acquire) == expanded) {
+        node = select(node);
+        node->visits.fetch_add(virtual_loss_, std::memory_order_relaxed);
+        atomic_add(node->value_sum, (float) -virtual_loss_);
+        if (node->move == pass_move)
+            position.pass();
+        else
+            position.play({node->move / N, node->move % N}, to_move);
+        to_move = opponent(to_move);
+        path[depth++] = node;
+    }
+
+    // value of the leaf from the view of the player to move
+    float value;
+    int state = unexpanded;
+    if (position.finished() || depth > max_depth) {
+        value = outcome(position, to_move, komi_);
+    } else if (node->state.compare_exchange_strong(state, expanding, std::memory_order_acquire)) {
+        value = expand(node, position, to_move);
+    } else {
+        // another thread expands this leaf, revert and try again
+        for (int i = 1; i < depth; ++i) {
+            path[i]->visits.fetch_sub(virtual_loss_, std::memory_order_relaxed);
+            atomic_add(path[i]->value_sum, (float) virtual_loss_);
+        }
+        collisions_++;
+        return false;
+    }
+
+    // backup: a node holds the value from the view of the player who moved into it
+    for (int i = depth - 1; i >= 0; --i) {
+        value = -value;
+        const int loss = (i > 0) ? virtual_loss_ : 0;
+        path[i]->visits.fetch_add(1 - loss, std::memory_order_relaxed);
+        atomic_add(path[i]->value_sum, value + loss);
+    }
+    return true;
+}
+
+template<int N>
+const typename basic_mcts_t<N>::node_t* basic_mcts_t<N>::child(coord_t move) const {
+    const int m = (move.first < 0) ? pass_move : move.first * N + move.second;
+    if (root_->state.load(std::memory_order_acquire) != expanded)
+        return nullptr;
+    for (int i = 0; i < root_->num_children; ++i)
+        if (root_->children[i].move == m)
+            return &root_->children[i];
+    return nullptr;
+}
+
+template<int N>
+coord_t basic_mcts_t<N>::best_move() const {
+    if (root_->state.load(std::memory_order_acquire) != expanded)
+        return {-1, -1};
+    const node_t *best = nullptr;
+    for (int i = 0; i < root_->num_children; ++i)
+        if (best == nullptr || root_->children[i].visits > best->visits)
+            best = &root_->children[i];
+    if (best->move == pass_move)
+        return {-1, -1};
+    return {best->move / N, best->move % N};
+}
+
+template<int N>
+int basic_mcts_t<N>::visits(coord_t move) const {
+    const node_t *c = child(move);
+    return (c == nullptr) ? 0 : c->visits.load();
+}
+
+template<int N>
+float basic_mcts_t<N>::value(coord_t move) const {
+    const node_t *c = child(move);
+    if (c == nullptr || c->visits == 0)
+        return 0.f;
+    return c->value_sum.load() / c->visits.load();
+}
+
+template<int N>
+int basic_mcts_t<N>::num_nodes() const {
+    return num_nodes_;
+}
+
+template<int N>
+int basic_mcts_t<N>::collisions() const {
+    return collisions_;
+}
+
+template class basic_uniform_evaluator_t<9>;
+template class basic_uniform_evaluator_t<13>;
+template class basic_uniform_evaluator_t<19>;
+template class basic_rollout_evaluator_t<9>;
+template class basic_rollout_evaluator_t<13>;
+template class basic_rollout_evaluator_t<19>;
+template class basic_mcts_t<9>;
+template class basic_mcts_t<13>;
+template class basic_mcts_t<19>;
@@ -0,0 +1,183 @@
+#ifndef ENGINE_MCTS_H
+#define ENGINE_MCTS_H
+
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <utility>
+
+#include "misc.h"
+#include "token_t.h"
+#include "playout.h"
+#include "transposition.h"
+
+/**
+ * @brief Interface of position evaluators for the search (policy priors + value)
+ * @details evaluate() is called concurrently by all search threads and has to be thread-safe.
+ */
+template<int N>
+class basic_evaluator_t {
+  public:
+    virtual ~basic_evaluator_t() {}
+
+    /**
+     * @brief prior probabilities of all moves and value of a position
+     *
+     * @param position position to evaluate
+     * @param to_move player to move
+     * @param priors output N*N+1 values (field x * N + y, the last entry is the pass), which do
+     *        not need to be normalized, illegal moves are masked by the search
+     * @return value of the position in [-1, 1] from the view of to_move
+     */
+    virtual float evaluate(const basic_playout_t<N> &position, token_t to_move, float *priors) = 0;
+};
+
+/**
+ * @brief uniform priors and value 0 (the search degenerates to a breadth-first search)
+ */
+template<int N>
+class basic_uniform_evaluator_t : public basic_evaluator_t<N> {
+  public:
+    float evaluate(const basic_playout_t<N> &position, token_t to_move, float *priors);
+};
+
+/**
+ * @brief uniform priors and the outcome of a light playout as value
+ */
+template<int N>
+class basic_rollout_evaluator_t : public basic_evaluator_t<N> {
+  public:
+    explicit basic_rollout_evaluator_t(float komi = 7.5f, std::uint64_t seed = 42);
+    float evaluate(const basic_playout_t<N> &position, token_t to_move, float *priors);
+
+  private:
+    float komi_;
+    std::atomic<std::uint64_t> seed_;
+};
+
+/**
+ * @brief Monte Carlo tree search with policy priors (PUCT) and tree parallelism
+ * @details All threads share one tree. A thread descends from the root by maximizing
+ *
+ *              Q(child) + c_puct * P(child) * sqrt(N(parent)) / (1 + N(child))
+ *
+ *          (unvisited children get the value of their parent as Q, "first play urgency")
+ *          and evaluates the reached leaf, whose value is backed up along the path. Visits and
+ *          values of a node are atomics (no locks). While a thread is below a node, the node
+ *          carries a virtual loss (virtual_loss visits, each lost), which steers the other
+ *          threads to different paths. Leaves are expanded by exactly one thread; a thread
+ *          which reaches a leaf under expansion reverts its virtual losses and starts over
+ *          (counted as collision).
+ *
+ *          Positions are basic_playout_t boards, hence only simple ko is enforced. A position
+ *          is terminal after two passes in a row and scored by area (see basic_playout_t::score).
+ *
+ *          With a transposition table, a leaf whose position was evaluated before (through
+ *          another move order, by another search or an earlier move) reuses priors and value
+ *          instead of calling the evaluator. The statistics of nodes are not shared.
+ */
+template<int N>
+class basic_mcts_t {
+  public:
+    /**
+     * @param evaluator priors and values of leaves (not owned)
+     * @param threads number of search threads
+     * @param c_puct weight of the priors
+     * @param komi points of white for terminal positions
+     * @param virtual_loss number of lost visits added to a node while a thread is below
+     */
+    basic_mcts_t(basic_evaluator_t<N> *evaluator, int threads = 1, float c_puct = 1.5f,
+                 float komi = 7.5f, int virtual_loss = 3);
+    ~basic_mcts_t();
+
+    /**
+     * @brief share evaluations of leaves through a table (not owned, nullptr to disable)
+     * @details The same table can be used by several searches at the same time.
+     */
+    void set_transposition_table(basic_transposition_table_t<N> *table);
+
+    /**
+     * @brief start a new search tree at a position
+     * @details Starts a new generation of the transposition table.
+     */
+    void set_position(const basic_playout_t<N> &position, token_t to_move);
+
+    /**
+     * @brief run simulations (distributed over all threads), the tree is kept between calls
+     * @return number of completed simulations
+     */
+    int search(int simulations);
+
+    /**
+     * @brief most visited move of the root
+     * @return position of the move or {-1, -1} for a pass
+     */
+    coord_t best_move() const;
+
+    /**
+     * @brief number of visits of a move of the root ({-1, -1} for the pass)
+     */
+    int visits(coord_t move) const;
+
+    /**
+     * @brief mean value of a move of the root from the view of the player to move
+     */
+    float value(coord_t move) const;
+
+    /**
+     * @brief number of nodes in the tree
+     */
+    int num_nodes() const;
+
+    /**
+     * @brief number of simulations which were restarted since a leaf was under expansion
+     */
+    int collisions() const;
+
+  private:
+    struct node_t {
+        node_t() : move(pass_move), prior(0.f), visits(0), value_sum(0.f), state(unexpanded),
+                   children(nullptr), num_children(0) {}
+        ~node_t() { delete[] children; }
+
+        /* field x * N + y or pass_move */
+        int move;
+        float prior;
+        /* visits and sum of values from the view of the player who played move */
+        std::atomic<int> visits;
+        std::atomic<float> value_sum;
+        std::atomic<int> state;
+        /* children are published by state == expanded */
+        node_t *children;
+        int num_children;
+    };
+
+    enum { unexpanded, expanding, expanded };
+    enum { pass_move = N * N, max_depth = 3 * N * N };
+
+    bool simulate(basic_playout_t<N> &position);
+    node_t* select(node_t *node) const;
+    float expand(node_t *node, const basic_playout_t<N> &position, token_t to_move);
+    const node_t* child(coord_t move) const;
+
+    basic_evaluator_t<N> *evaluator_;
+    int threads_;
+    float c_puct_;
+    float komi_;
+    int virtual_loss_;
+    basic_transposition_table_t<N> *table_;
+
+    node_t *root_;
+    basic_playout_t<N> root_position_;
+    token_t root_to_move_;
+
+    std::atomic<int> num_nodes_;
+    std::atomic<int> collisions_;
+};
+
+typedef basic_evaluator_t<19> evaluator_t;
+typedef basic_uniform_evaluator_t<19> uniform_evaluator_t;
+typedef basic_rollout_evaluator_t<19> rollout_evaluator_t;
+typedef basic_mcts_t<19> mcts_t;
+
+#endif
@@ -3,10 +3,12 @@
 #ifndef ENGINE_MISC_H
 #define ENGINE_MISC_H
 
+// default board size, board templates (e.g. basic_board_t<N>) shadow N by their own size
 const int N = 19;
 
-#define map2line(x,y) (((x) * 19 + (y)))
-#define map3line(n,x,y) (( (n*19*19) +  (x) * 19 + (y)))
+// index helpers refer to the innermost N, which is a compile-time constant in any case
+#define map2line(x,y) (((x) * N + (y)))
+#define map3line(n,x,y) (( ((n)*N*N) +  (x) * N + (y)))
 #define valid_pos(x) (((x>=0) && (x < N)))
 
 
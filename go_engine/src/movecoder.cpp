@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <vector>
+
+#include "movecoder.h"
+
+namespace {
+
+const int prob_bits = 11;
+const std::uint16_t prob_init = 1 << (prob_bits - 1);
+const int adapt_shift = 4;
+const std::uint32_t top = 1 << 24;
+
+// every action codes its kind by 6 binary decisions, adaptive probabilities stay within
+// 2^prob_bits - 15 of 2^prob_bits, hence a decision costs at least 1/96 bit and a byte of the
+// stream holds fewer than 8 * 96 / 6 actions
+const unsigned int max_actions_per_byte = 128;
+
+template<size_t n>
+void fill(std::uint16_t (&probs)[n]) {
+    std::fill(probs, probs + n, prob_init);
+}
+
+/**
+ * @brief initialize a bit tree such that it starts with a prior distribution of its leafs
+ * @details games are short, learning the distribution from a uniform start is expensive
+ */
+void prior(std::uint16_t *probs, int nbits, const std::vector<float> &weights) {
+    const int leafs = 1 << nbits;
+    std::vector<float> mass(2 * leafs, 0.f);
+    for (int i = 0; i < leafs; ++i)
+        mass[leafs + i] = (i < (int) weights.size()) ? weights[i] : 0.f;
+    for (int m = leafs - 1; m >= 1; --m) {
+        mass[m] = mass[2 * m] + mass[2 * m + 1];
+        // probability of bit 0 at node m
+        const float p = (mass[m] > 0) ? mass[2 * m] / mass[m] : 0.5f;
+        const int q = (int)(p * (1 << prob_bits));
+        probs[m] = (std::uint16_t) std::max(31, std::min((1 << prob_bits) - 31, q));
+    }
+}
+
+}  // namespace
+
+
+move_model_t::move_model_t() {
+    *this = initial();
+}
+
+const move_model_t& move_model_t::initial() {
+    static const move_model_t model{prior_tag()};
+    return model;
+}
+
+move_model_t::move_model_t(prior_tag) : pass_position(prob_init), on_board(prob_init), last_kind(0), last_near(0) {
+    for (int i = 0; i < 64; ++i)
+        fill(kind[i]);
+    for (int i = 0; i < 2; ++i) {
+        fill(near[i]);
+        fill(offset[i]);
+    }
+    for (int i = 0; i < 2; ++i) {
+        fill(edge[i]);
+        side[i] = prob_init;
+    }
+    fill(absolute);
+    ref[0] = ref[1] = -1;
+
+    // the color alternates, setup stones come in a row, flags (bit 3) may change with the color
+    for (int k = 0; k < 64; ++k) {
+        std::vector<float> w(64, 0.05f);
+        w[k] = 4.f;
+        w[k ^ 1] = 16.f;
+        w[(k ^ 1) ^ 8] = 16.f;
+        w[((k ^ 1) | 2) & ~4] = std::max(w[((k ^ 1) | 2) & ~4], 4.f);
+        prior(kind[k], 6, w);
+    }
+
+    // moves close to the last one are more likely
+    std::vector<float> w(64, 0.001f);
+    for (int off = 0; off < (2 * window + 1) * (2 * window + 1); ++off) {
+        const int dx = off % (2 * window + 1) - window;
+        const int dy = off / (2 * window + 1) - window;
+        w[off] = (dx == 0 && dy == 0) ? 0.05f : 1.f + 8.f / (dx * dx + dy * dy);
+    }
+    prior(offset[0], 6, w);
+    prior(offset[1], 6, w);
+
+    // distance to the closest edge (3rd and 4th line dominate)
+    const std::vector<float> lines = {1.f, 3.f, 10.f, 10.f, 5.f, 3.f, 2.5f, 2.f, 2.f, 1.f};
+    prior(edge[0], 4, lines);
+    prior(edge[1], 4, lines);
+}
+
+void move_model_t::update(int value) {
+    last_kind = (value >> 10) & 63;
+    // passes do not have a position
+    if (value & 4096)
+        return;
+    ref[1] = ref[0];
+    ref[0] = value & 1023;
+}
+
+int move_model_t::near_offset(int ref, int pos) const {
+    if (ref < 0)
+        return -1;
+    const int dx = (pos & 31) - (ref & 31);
+    const int dy = (pos >> 5) - (ref >> 5);
+    if (dx < -window || dx > window || dy < -window || dy > window)
+        return -1;
+    return (dy + window) * (2 * window + 1) + (dx + window);
+}
+
+int move_model_t::from_offset(int ref, int off) const {
+    const int dx = off % (2 * window + 1) - window;
+    const int dy = off / (2 * window + 1) - window;
+    return ((ref >> 5) + dy) * 32 + (ref & 31) + dx;
+}
+
+
+move_encoder_t::move_encoder_t() : low_(0), range_(0xFFFFFFFF), cache_(0), cache_size_(1) {}
+
+std::vector<unsigned char> move_encoder_t::compress(const unsigned char *moves, int len) {
+    move_encoder_t enc;
+
+    // number of actions as varint
+    unsigned int n = len / 2;
+    do {
+        enc.out_.push_back((unsigned char)((n & 127) | ((n > 127) ? 128 : 0)));
+        n >>= 7;
+    } while (n > 0);
+
+    for (int i = 0; i + 1 < len; i += 2)
+        enc.encode((moves[i] << 8) | moves[i + 1]);
+    enc.flush();
+    return enc.out_;
+}
+
+void move_encoder_t::encode(int value) {
+    const int kind = (value >> 10) & 63;
+    tree(model_.kind[model_.last_kind], 6, kind);
+
+    if (!(value & 4096)) {
+        const int pos = value & 1023;
+        int off = model_.near_offset(model_.ref[0], pos);
+        bit(&model_.near[0][model_.last_near], off >= 0);
+        if (off >= 0) {
+            tree(model_.offset[0], 6, off);
+            model_.last_near = 1;
+        } else {
+            off = model_.near_offset(model_.ref[1], pos);
+            bit(&model_.near[1][model_.last_near], off >= 0);
+            if (off >= 0)
+                tree(model_.offset[1], 6, off);
+            else
+                absolute(pos);
+            model_.last_near = 0;
+        }
+    } else {
+        bit(&model_.pass_position, (value & 1023) != 0);
+        if (value & 1023)
+            tree(model_.absolute, 10, value & 1023);
+    }
+    model_.update(value);
+}
+
+void move_encoder_t::absolute(int pos) {
+    const int x = pos & 31;
+    const int y = pos >> 5;
+    const bool on_board = (x < 19) && (y < 19);
+    bit(&model_.on_board, !on_board);
+    if (!on_board) {
+        tree(model_.absolute, 10, pos);
+        return;
+    }
+    const int coords[2] = {x, y};
+    for (int i = 0; i < 2; ++i) {
+        const int c = coords[i];
+        tree(model_.edge[i], 4, std::min(c, 18 - c));
+        if (c != 9)
+            bit(&model_.side[i], c > 9);
+    }
+}
+
+void move_encoder_t::bit(std::uint16_t *prob, int b) {
+    const std::uint32_t bound = (range_ >> prob_bits) * (*prob);
+    if (b == 0) {
+        range_ = bound;
+        *prob += ((1 << prob_bits) - *prob) >> adapt_shift;
+    } else {
+        low_ += bound;
+        range_ -= bound;
+        *prob -= *prob >> adapt_shift;
+    }
+    while (range_ < top) {
+        range_ <<= 8;
+        shift_low();
+    }
+}
+
+void move_encoder_t::tree(std::uint16_t *probs, int nbits, int value) {
+    int m = 1;
+    for (int i = nbits - 1; i >= 0; --i) {
+        const int b = (value >> i) & 1;
+        bit(&probs[m], b);
+        m = (m << 1) | b;
+    }
+}
+
+void move_encoder_t::shift_low() {
+    if ((std::uint32_t) low_ < 0xFF000000U || (low_ >> 32) != 0) {
+        const unsigned char carry = (unsigned char)(low_ >> 32);
+        unsigned char temp = cache_;
+        do {
+            out_.push_back((unsigned char)(temp + carry));
+            temp = 0xFF;
+        } while (--cache_size_ != 0);
+        cache_ = (unsigned char)(low_ >> 24);
+    }
+    cache_size_++;
+    low_ = (low_ & 0x00FFFFFF) << 8;
+}
+
+void move_encoder_t::flush() {
+    for (int i = 0; i < 5; ++i)
+        shift_low();
+}
+
+
+move_decoder_t::move_decoder_t()
+    : pos_(0), num_actions_(0), range_(0xFFFFFFFF), code_(0) {}
+
+bool move_decoder_t::reset(const unsigned char *stream, int len) {
+    model_ = move_model_t();
+    stream_.assign(stream, stream + len);
+    pos_ = 0;
+
+    num_actions_ = 0;
+    for (int shift = 0; pos_ < stream_.size() && shift < 32; shift += 7) {
+        const unsigned char b = stream_[pos_++];
+        num_actions_ |= (unsigned int)(b & 127) << shift;
+        if (!(b & 128))
+            break;
+    }
+
+    const std::uint64_t coded = stream_.size() - pos_;
+
+    range_ = 0xFFFFFFFF;
+    code_ = 0;
+    for (int i = 0; i < 5; ++i)
+        code_ = (code_ << 8) | byte();
+
+    // the count is untrusted, a corrupt one must not allocate and decode billions of actions
+    if (num_actions_ > coded * max_actions_per_byte) {
+        num_actions_ = 0;
+        return false;
+    }
+    return true;
+}
+
+const unsigned int move_decoder_t::num_actions() const {
+    return num_actions_;
+}
+
+std::uint16_t move_decoder_t::next() {
+    const int kind = tree(model_.kind[model_.last_kind], 6);
+    int value = kind << 10;
+
+    if (!(value & 4096)) {
+        int pos = 0;
+        if (bit(&model_.near[0][model_.last_near])) {
+            pos = model_.from_offset(model_.ref[0], tree(model_.offset[0], 6));
+            model_.last_near = 1;
+        } else {
+            if (bit(&model_.near[1][model_.last_near]))
+                pos = model_.from_offset(model_.ref[1], tree(model_.offset[1], 6));
+            else
+                pos = absolute();
+            model_.last_near = 0;
+        }
+        value |= pos & 1023;
+    } else if (bit(&model_.pass_position)) {
+        value |= tree(model_.absolute, 10);
+    }
+    model_.update(value);
+    return (std::uint16_t) value;
+}
+
+int move_decoder_t::absolute() {
+    if (bit(&model_.on_board))
+        return tree(model_.absolute, 10);
+    int coords[2];
+    for (int i = 0; i < 2; ++i) {
+        const int d = tree(model_.edge[i], 4);
+        coords[i] = (d != 9 && bit(&model_.side[i])) ? 18 - d : d;
+    }
+    return coords[1] * 32 + coords[0];
+}
+
+int move_decoder_t::bit(std::uint16_t *prob) {
+    const std::uint32_t bound = (range_ >> prob_bits) * (*prob);
+    int b;
+    if (code_ < bound) {
+        range_ = bound;
+        *prob += ((1 << prob_bits) - *prob) >> adapt_shift;
+        b = 0;
+    } else {
+        code_ -= bound;
+        range_ -= bound;
+        *prob -= *prob >> adapt_shift;
+        b = 1;
+    }
+    while (range_ < top) {
+        range_ <<= 8;
+        code_ = (code_ << 8) | byte();
+    }
+    return b;
+}
+
+int move_decoder_t::tree(std::uint16_t *probs, int nbits) {
+    int m = 1;
+    for (int i = 0; i < nbits; ++i)
+        m = (m << 1) | bit(&probs[m]);
+    return m - (1 << nbits);
+}
+
+unsigned char move_decoder_t::byte() {
+    // reading beyond the end of a (truncated) stream yields zeros
+    return (pos_ < stream_.size()) ? stream_[pos_++] : 0;
+}
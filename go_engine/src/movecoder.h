@@ -0,0 +1,130 @@
+#ifndef ENGINE_MOVECODER_H
+#define ENGINE_MOVECODER_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Adaptive context model shared by encoder and decoder of compressed move streams
+ * @details Each 2-byte move (---pmcyyyyyxxxxx) is split into
+ *            - the upper 6 bits (flags, pass, move, color) coded with the previous ones as context
+ *            - the position (not for passes) coded relative to the last action ("near"),
+ *              relative to the action before that or as absolute position
+ *          Near means both offsets are within [-3, 3], i.e. a 7x7 window. Absolute positions on a
+ *          19x19 board are coded as distance to the closest edge and side per axis, since the
+ *          distribution of moves is nearly symmetric (3rd and 4th line). Passes usually have
+ *          no position bits, otherwise these are stored as well to keep the coding lossless.
+ *          All bits are coded by an adaptive binary range coder (11 bit probabilities).
+ */
+struct move_model_t {
+    static const int window = 3;
+
+    /**
+     * @brief initial state (copied from a precomputed model, the priors are built only once)
+     */
+    move_model_t();
+
+    std::uint16_t kind[64][64];
+    std::uint16_t pass_position;
+    std::uint16_t near[2][2];
+    std::uint16_t offset[2][64];
+    std::uint16_t on_board;
+    std::uint16_t edge[2][16];
+    std::uint16_t side[2];
+    std::uint16_t absolute[1024];
+
+    int last_kind;
+    int ref[2];
+    int last_near;
+
+    /**
+     * @brief remember position of an action (passes do not change the references)
+     */
+    void update(int value);
+
+    /**
+     * @brief index into 7x7 window around ref or -1 if not near
+     */
+    int near_offset(int ref, int pos) const;
+    int from_offset(int ref, int off) const;
+
+  private:
+    struct prior_tag {};
+    explicit move_model_t(prior_tag);
+    static const move_model_t& initial();
+};
+
+/**
+ * @brief Compress raw SGFbin moves into an entropy coded move stream
+ * @details The stream starts with the number of actions (varint) followed by the range coder
+ *          output. See docs/FILEFORMAT.md.
+ */
+class move_encoder_t {
+  public:
+    /**
+     * @brief compress moves (2 bytes per action)
+     *
+     * @param moves raw moves as stored in SGFbin files
+     * @param len length of buffer in bytes
+     * @return compressed stream
+     */
+    static std::vector<unsigned char> compress(const unsigned char *moves, int len);
+
+  private:
+    move_encoder_t();
+    void encode(int value);
+    void absolute(int pos);
+    void bit(std::uint16_t *prob, int b);
+    void tree(std::uint16_t *probs, int nbits, int value);
+    void shift_low();
+    void flush();
+
+    move_model_t model_;
+    std::uint64_t low_;
+    std::uint32_t range_;
+    unsigned char cache_;
+    std::uint64_t cache_size_;
+    std::vector<unsigned char> out_;
+};
+
+/**
+ * @brief Streaming decoder of compressed move streams
+ * @details Moves are decoded one at a time in game order, this is fast enough to be used
+ *          directly while replaying a game.
+ */
+class move_decoder_t {
+  public:
+    move_decoder_t();
+
+    /**
+     * @brief start decoding a compressed stream (a copy of the buffer is kept)
+     * @return false if the stream cannot hold the number of actions in its header (corrupt),
+     *         num_actions() is 0 then
+     */
+    bool reset(const unsigned char *stream, int len);
+
+    /**
+     * @brief total number of actions in the stream
+     */
+    const unsigned int num_actions() const;
+
+    /**
+     * @brief decode next action into its raw 2-byte representation
+     */
+    std::uint16_t next();
+
+  private:
+    int absolute();
+    int bit(std::uint16_t *prob);
+    int tree(std::uint16_t *probs, int nbits);
+    unsigned char byte();
+
+    move_model_t model_;
+    std::vector<unsigned char> stream_;
+    size_t pos_;
+    unsigned int num_actions_;
+    std::uint32_t range_;
+    std::uint32_t code_;
+};
+
+#endif
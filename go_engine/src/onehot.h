@@ -0,0 +1,56 @@
+#ifndef ENGINE_ONEHOT_H
+#define ENGINE_ONEHOT_H
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief expand per-point values into 8 one-hot planes (1, 2, ..., 7, more than 7)
+ * @details Plane k is 1 where value == k + 1 (k < 7), plane 7 is 1 where value > 7,
+ *          everything else is 0. In contrast to setting single entries, complete planes are
+ *          written, which allows vectorized compare-and-store kernels. AVX2 is used when
+ *          compiled with -mavx2 (or -march=native), SSE2 otherwise and a scalar loop as
+ *          fallback on other architectures.
+ *
+ * @param values n values (e.g. 19x19 liberty counts)
+ * @param planes 8 planes of n values each
+ * @param n number of values per plane
+ */
+inline void one_hot_planes(const int *values, int *planes, const int n) {
+    int i = 0;
+#if defined(__AVX2__)
+    const __m256i one = _mm256_set1_epi32(1);
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(values + i));
+        for (int k = 0; k < 7; ++k) {
+            const __m256i hit = _mm256_cmpeq_epi32(v, _mm256_set1_epi32(k + 1));
+            _mm256_storeu_si256((__m256i*)(planes + k * n + i), _mm256_and_si256(hit, one));
+        }
+        const __m256i more = _mm256_cmpgt_epi32(v, _mm256_set1_epi32(7));
+        _mm256_storeu_si256((__m256i*)(planes + 7 * n + i), _mm256_and_si256(more, one));
+    }
+#elif defined(__SSE2__)
+    const __m128i one = _mm_set1_epi32(1);
+    for (; i + 4 <= n; i += 4) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(values + i));
+        for (int k = 0; k < 7; ++k) {
+            const __m128i hit = _mm_cmpeq_epi32(v, _mm_set1_epi32(k + 1));
+            _mm_storeu_si128((__m128i*)(planes + k * n + i), _mm_and_si128(hit, one));
+        }
+        const __m128i more = _mm_cmpgt_epi32(v, _mm_set1_epi32(7));
+        _mm_storeu_si128((__m128i*)(planes + 7 * n + i), _mm_and_si128(more, one));
+    }
+#endif
+    // remaining points (all points without SIMD)
+    for (; i < n; ++i) {
+        const int v = values[i];
+        for (int k = 0; k < 7; ++k)
+            planes[k * n + i] = (v == k + 1);
+        planes[7 * n + i] = (v > 7);
+    }
+}
+
+#endif
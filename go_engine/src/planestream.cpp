@@ -0,0 +1,133 @@
+#include <algorithm>
+
+#include "planestream.h"
+
+namespace {
+
+const int area = 19 * 19;
+
+void put_varint(unsigned int value, std::vector<unsigned char> *out) {
+    do {
+        out->push_back((unsigned char)((value & 127) | ((value > 127) ? 128 : 0)));
+        value >>= 7;
+    } while (value > 0);
+}
+
+bool get_varint(const unsigned char *buffer, int len, int *pos, unsigned int *value) {
+    *value = 0;
+    for (int shift = 0; *pos < len && shift < 32; shift += 7) {
+        const unsigned char b = buffer[(*pos)++];
+        *value |= (unsigned int)(b & 127) << shift;
+        if (!(b & 128))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief view the tensor of feature_planes from the other player
+ */
+template<typename T>
+void swap_perspective(const std::vector<T> &src, std::vector<T> *dst) {
+    *dst = src;
+    T *d = dst->data();
+    const T *s = src.data();
+    std::copy(s + 1 * area, s + 2 * area, d);
+    std::copy(s, s + area, d + area);
+    std::copy(s + 20 * area, s + 28 * area, d + 12 * area);
+    std::copy(s + 12 * area, s + 20 * area, d + 20 * area);
+    for (int i = 48 * area; i < 49 * area; ++i)
+        d[i] = 1 - s[i];
+}
+
+}  // namespace
+
+
+plane_stream_encoder_t::plane_stream_encoder_t(int num_planes)
+    : previous_(num_planes * area, 0), can_swap_(num_planes >= 49) {}
+
+void plane_stream_encoder_t::reset() {
+    std::fill(previous_.begin(), previous_.end(), 0);
+}
+
+int plane_stream_encoder_t::encode(const int *planes, std::vector<unsigned char> *out) {
+    const unsigned int n = previous_.size();
+
+    // which reference needs fewer flips?
+    bool swap = false;
+    if (can_swap_) {
+        swap_perspective(previous_, &swapped_);
+        int direct = 0, swapped = 0;
+        for (unsigned int i = 0; i < n; ++i) {
+            const unsigned char value = (planes[i] != 0);
+            direct += (value != previous_[i]);
+            swapped += (value != swapped_[i]);
+        }
+        swap = swapped < direct;
+        if (swap)
+            previous_.swap(swapped_);
+    }
+
+    std::vector<unsigned int> flips;
+    for (unsigned int i = 0; i < n; ++i) {
+        const unsigned char value = (planes[i] != 0);
+        if (value != previous_[i]) {
+            flips.push_back(i);
+            previous_[i] = value;
+        }
+    }
+
+    put_varint(2 * flips.size() + swap, out);
+    unsigned int last = 0;
+    for (unsigned int i : flips) {
+        // last is the previous index + 1
+        put_varint(i - last, out);
+        last = i + 1;
+    }
+    return flips.size();
+}
+
+
+plane_stream_decoder_t::plane_stream_decoder_t(int num_planes) : current_(num_planes * area, 0) {}
+
+void plane_stream_decoder_t::reset() {
+    std::fill(current_.begin(), current_.end(), 0);
+}
+
+int plane_stream_decoder_t::decode(const unsigned char *frame, int len, int *planes) {
+    int pos = 0;
+    unsigned int header = 0;
+    if (!get_varint(frame, len, &pos, &header))
+        return -1;
+    const bool swap = header & 1;
+    if (swap && current_.size() < 49 * area)
+        return -1;
+
+    // validate the whole frame before touching the state, a corrupt frame changes nothing
+    const int first_gap = pos;
+    const unsigned int num_flips = header >> 1;
+    unsigned int next = 0;
+    for (unsigned int f = 0; f < num_flips; ++f) {
+        unsigned int gap = 0;
+        if (!get_varint(frame, len, &pos, &gap) || gap >= current_.size() - next)
+            return -1;
+        next += gap + 1;
+    }
+
+    if (swap) {
+        swap_perspective(current_, &swapped_);
+        current_.swap(swapped_);
+    }
+
+    int at = first_gap;
+    next = 0;
+    for (unsigned int f = 0; f < num_flips; ++f) {
+        unsigned int gap = 0;
+        get_varint(frame, len, &at, &gap);
+        current_[next + gap] ^= 1;
+        next += gap + 1;
+    }
+
+    std::copy(current_.begin(), current_.end(), planes);
+    return pos;
+}
@@ -0,0 +1,79 @@
+#ifndef ENGINE_PLANESTREAM_H
+#define ENGINE_PLANESTREAM_H
+
+#include <vector>
+
+/**
+ * @brief Delta encoding of feature planes of consecutive positions
+ * @details Consecutive positions of a game differ in only a few (plane, point) entries. Each
+ *          frame stores the entries which flipped relative to the previous frame:
+ *
+ *              [varint number of flips][varint gap]...
+ *
+ *          where the flipped entries (index = plane * 361 + point) are sorted and stored as gap
+ *          to the previous flipped index + 1 (the first one relative to -1). The first frame
+ *          after reset() is relative to an all-zero tensor. Only binary planes are supported,
+ *          any non-zero value counts as set.
+ *
+ *          The perspective of board_t::feature_planes alternates from move to move, which flips
+ *          every stone and the colour plane. For tensors with the layout of feature_planes
+ *          (at least 49 planes) the lowest bit of the count marks frames which are relative
+ *          to the previous tensor seen from the other player, i.e. with own/opponent stone
+ *          (0, 1) and liberty planes (12-19, 20-27) exchanged and plane 48 inverted. The
+ *          encoder picks whichever reference needs fewer flips.
+ */
+class plane_stream_encoder_t {
+  public:
+    /**
+     * @param num_planes number of planes per position (e.g. 49)
+     */
+    explicit plane_stream_encoder_t(int num_planes = 49);
+
+    /**
+     * @brief start a new stream (next frame is relative to zeros)
+     */
+    void reset();
+
+    /**
+     * @brief append the frame of a position
+     *
+     * @param planes num_planes x 19 x 19 values
+     * @param out frame is appended here
+     * @return number of flipped entries
+     */
+    int encode(const int *planes, std::vector<unsigned char> *out);
+
+  private:
+    std::vector<unsigned char> previous_;
+    std::vector<unsigned char> swapped_;
+    bool can_swap_;
+};
+
+/**
+ * @brief Reconstruct full plane tensors from a delta encoded stream
+ */
+class plane_stream_decoder_t {
+  public:
+    explicit plane_stream_decoder_t(int num_planes = 49);
+
+    /**
+     * @brief start a new stream (next frame is relative to zeros)
+     */
+    void reset();
+
+    /**
+     * @brief apply a single frame and write the full tensor
+     *
+     * @param frame start of the frame
+     * @param len available bytes
+     * @param planes num_planes x 19 x 19 output values (completely overwritten)
+     * @return number of consumed bytes or -1 if the frame is corrupt (the state is unchanged)
+     */
+    int decode(const unsigned char *frame, int len, int *planes);
+
+  private:
+    std::vector<int> current_;
+    std::vector<int> swapped_;
+};
+
+#endif
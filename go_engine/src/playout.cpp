@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <vector>
+
+#include "playout.h"
+#include "board_t.h"
+#include "hash_t.h"
+
+namespace {
+
+const std::uint8_t border = 3;
+
+// keys of the player to move and the ko field, not part of the stone hash
+const std::uint64_t white_to_move_key = 0x7a3d5c1e9b2f4d61ULL;
+
+inline std::uint64_t ko_key(int p) {
+    // splitmix64 finalizer
+    std::uint64_t z = (std::uint64_t) (p + 1) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+inline token_t opponent(token_t tok) {
+    return (tok == white) ? black : white;
+}
+
+}  // namespace
+
+
+template<int N>
+basic_playout_t<N>::basic_playout_t(std::uint64_t seed) : rng_(seed) {
+    clear();
+}
+
+template<int N>
+void basic_playout_t<N>::clear() {
+    num_empty_ = 0;
+    for (int p = 0; p < W * W; ++p) {
+        const int x = p / W - 1;
+        const int y = p % W - 1;
+        color_[p] = (valid_pos(x) && valid_pos(y)) ? (std::uint8_t) empty : border;
+        group_[p] = 0;
+        next_[p] = p;
+        libs_[p] = 0;
+        size_[p] = 0;
+        empty_index_[p] = -1;
+        if (color_[p] == empty)
+            add_empty(p);
+    }
+    ko_ = -1;
+    passes_ = 0;
+    hash_ = 0;
+}
+
+template<int N>
+void basic_playout_t<N>::load(const basic_board_t<N> &b) {
+    clear();
+    const int delta[4] = {-W, W, -1, 1};
+
+    for (int x = 0; x < N; ++x)
+        for (int y = 0; y < N; ++y) {
+            const token_t tok = b.fields[x][y].token();
+            if (tok == empty)
+                continue;
+            const int p = index(x, y);
+            const int last = empty_[--num_empty_];
+            empty_[empty_index_[p]] = last;
+            empty_index_[last] = empty_index_[p];
+            empty_index_[p] = -1;
+            color_[p] = tok;
+            hash_ ^= hash_t[tok - 1][x][y];
+        }
+
+    // every stone starts as its own group, connected stones are merged afterwards
+    for (int p = 0; p < W * W; ++p) {
+        if (color_[p] != white && color_[p] != black)
+            continue;
+        group_[p] = p;
+        next_[p] = p;
+        size_[p] = 1;
+        for (int k = 0; k < 4; ++k)
+            libs_[p] += (color_[p + delta[k]] == empty);
+    }
+    for (int p = 0; p < W * W; ++p) {
+        if (color_[p] != white && color_[p] != black)
+            continue;
+        for (int k = 0; k < 4; ++k) {
+            const int q = p + delta[k];
+            if (color_[q] == color_[p] && group_[q] != group_[p])
+                merge(group_[p], group_[q]);
+        }
+    }
+
+    if (valid_pos(b.ko.first) && valid_pos(b.ko.second))
+        ko_ = index(b.ko.first, b.ko.second);
+}
+
+template<int N>
+void basic_playout_t<N>::add_empty(int p) {
+    empty_index_[p] = num_empty_;
+    empty_[num_empty_++] = p;
+}
+
+template<int N>
+int basic_playout_t<N>::adjacency(int p, int g) const {
+    const int delta[4] = {-W, W, -1, 1};
+    int n = 0;
+    for (int k = 0; k < 4; ++k)
+        n += (group_[p + delta[k]] == g);
+    return n;
+}
+
+template<int N>
+bool basic_playout_t<N>::legal(int p, token_t tok) const {
+    if (color_[p] != empty || p == ko_)
+        return false;
+
+    // legal if there is an empty neighbor, a captured opponent group or an own group
+    // which keeps another liberty
+    const int delta[4] = {-W, W, -1, 1};
+    for (int k = 0; k < 4; ++k) {
+        const int q = p + delta[k];
+        const std::uint8_t c = color_[q];
+        if (c == empty)
+            return true;
+        if (c == border)
+            continue;
+        const int g = group_[q];
+        const int adjacent = adjacency(p, g);
+        if (c == tok && libs_[g] > adjacent)
+            return true;
+        if (c != tok && libs_[g] == adjacent)
+            return true;
+    }
+    return false;
+}
+
+template<int N>
+bool basic_playout_t<N>::is_eye(int p, token_t tok) const {
+    const int delta[4] = {-W, W, -1, 1};
+    for (int k = 0; k < 4; ++k) {
+        const std::uint8_t c = color_[p + delta[k]];
+        if (c != tok && c != border)
+            return false;
+    }
+
+    // false eyes have too many opponent stones on the diagonals
+    const int diagonal[4] = {-W - 1, -W + 1, W - 1, W + 1};
+    const token_t other = opponent(tok);
+    int bad = 0, edge = 0;
+    for (int k = 0; k < 4; ++k) {
+        const std::uint8_t c = color_[p + diagonal[k]];
+        if (c == border)
+            edge = 1;
+        else if (c == other)
+            bad++;
+    }
+    return bad + edge < 2;
+}
+
+template<int N>
+void basic_playout_t<N>::merge(int a, int b) {
+    if (size_[a] < size_[b])
+        std::swap(a, b);
+    int s = b;
+    do {
+        group_[s] = a;
+        s = next_[s];
+    } while (s != b);
+    std::swap(next_[a], next_[b]);
+    libs_[a] += libs_[b];
+    size_[a] += size_[b];
+}
+
+template<int N>
+void basic_playout_t<N>::remove_group(int g) {
+    const int delta[4] = {-W, W, -1, 1};
+    int s = g;
+    do {
+        const int following = next_[s];
+        hash_ ^= hash_t[color_[s] - 1][s / W - 1][s % W - 1];
+        color_[s] = empty;
+        group_[s] = 0;
+        next_[s] = s;
+        add_empty(s);
+        // every neighboring stone gains a (pseudo-)liberty
+        for (int k = 0; k < 4; ++k)
+            libs_[group_[s + delta[k]]]++;
+        s = following;
+    } while (s != g);
+    // stones of this group or empty fields do not matter (index 0 is a border field)
+    libs_[0] = 0;
+}
+
+template<int N>
+void basic_playout_t<N>::place(int p, token_t tok) {
+    const int delta[4] = {-W, W, -1, 1};
+    const token_t other = opponent(tok);
+
+    const int last = empty_[--num_empty_];
+    empty_[empty_index_[p]] = last;
+    empty_index_[last] = empty_index_[p];
+    empty_index_[p] = -1;
+
+    color_[p] = tok;
+    hash_ ^= hash_t[tok - 1][p / W - 1][p % W - 1];
+    group_[p] = p;
+    next_[p] = p;
+    size_[p] = 1;
+    libs_[p] = 0;
+    for (int k = 0; k < 4; ++k) {
+        const int q = p + delta[k];
+        if (color_[q] == empty)
+            libs_[p]++;
+        else if (color_[q] != border)
+            libs_[group_[q]]--;
+    }
+
+    for (int k = 0; k < 4; ++k) {
+        const int q = p + delta[k];
+        if (color_[q] == tok && group_[q] != group_[p])
+            merge(group_[p], group_[q]);
+    }
+
+    int captured = 0, captured_at = -1;
+    for (int k = 0; k < 4; ++k) {
+        const int q = p + delta[k];
+        if (color_[q] == other && libs_[group_[q]] == 0) {
+            captured += size_[group_[q]];
+            captured_at = q;
+            remove_group(group_[q]);
+        }
+    }
+
+    // a single stone which captured a single stone and has just this liberty
+    const int g = group_[p];
+    ko_ = (captured == 1 && size_[g] == 1 && libs_[g] == 1) ? captured_at : -1;
+}
+
+template<int N>
+bool basic_playout_t<N>::is_legal(coord_t pos, token_t tok) const {
+    if (!valid_pos(pos.first) || !valid_pos(pos.second))
+        return false;
+    return legal(index(pos.first, pos.second), tok);
+}
+
+template<int N>
+bool basic_playout_t<N>::play(coord_t pos, token_t tok) {
+    if (!is_legal(pos, tok))
+        return false;
+    place(index(pos.first, pos.second), tok);
+    passes_ = 0;
+    return true;
+}
+
+template<int N>
+coord_t basic_playout_t<N>::play_random(token_t tok) {
+    // draw among the first candidates of the empty fields, rejected fields are swapped behind
+    // them, hence every acceptable field has the same chance
+    for (int candidates = num_empty_; candidates > 0; --candidates) {
+        const int j = rng_.uniform(candidates);
+        const int p = empty_[j];
+        if (legal(p, tok) && !is_eye(p, tok)) {
+            place(p, tok);
+            passes_ = 0;
+            return {p / W - 1, p % W - 1};
+        }
+        const int last = empty_[candidates - 1];
+        empty_[j] = last;
+        empty_index_[last] = j;
+        empty_[candidates - 1] = p;
+        empty_index_[p] = candidates - 1;
+    }
+    pass();
+    return {-1, -1};
+}
+
+template<int N>
+void basic_playout_t<N>::pass() {
+    ko_ = -1;
+    passes_++;
+}
+
+template<int N>
+void basic_playout_t<N>::seed(std::uint64_t seed) {
+    rng_ = fast_rng_t(seed);
+}
+
+template<int N>
+int basic_playout_t<N>::run(token_t to_move, int max_moves) {
+    int moves = 0;
+    token_t tok = to_move;
+    while (passes_ < 2 && moves < max_moves) {
+        play_random(tok);
+        tok = opponent(tok);
+        moves++;
+    }
+    return moves;
+}
+
+template<int N>
+bool basic_playout_t<N>::finished() const {
+    return passes_ >= 2;
+}
+
+template<int N>
+float basic_playout_t<N>::score(float komi) const {
+    const int delta[4] = {-W, W, -1, 1};
+    int points[3] = {0, 0, 0};
+    std::vector<bool> visited(W * W, false);
+    std::vector<int> stack;
+
+    for (int p = 0; p < W * W; ++p) {
+        if (color_[p] == white || color_[p] == black) {
+            points[color_[p]]++;
+            continue;
+        }
+        if (color_[p] != empty || visited[p])
+            continue;
+
+        // flood fill an empty region and record the colors it reaches
+        int region = 0;
+        bool reaches[3] = {false, false, false};
+        stack.push_back(p);
+        visited[p] = true;
+        while (!stack.empty()) {
+            const int q = stack.back();
+            stack.pop_back();
+            region++;
+            for (int k = 0; k < 4; ++k) {
+                const int r = q + delta[k];
+                const std::uint8_t c = color_[r];
+                if (c == empty && !visited[r]) {
+                    visited[r] = true;
+                    stack.push_back(r);
+                } else if (c == white || c == black) {
+                    reaches[c] = true;
+                }
+            }
+        }
+        if (reaches[black] != reaches[white])
+            points[reaches[black] ? black : white] += region;
+    }
+    return points[black] - points[white] - komi;
+}
+
+template<int N>
+token_t basic_playout_t<N>::token(coord_t pos) const {
+    return (token_t) color_[index(pos.first, pos.second)];
+}
+
+template<int N>
+std::uint64_t basic_playout_t<N>::hash() const {
+    return hash_;
+}
+
+template<int N>
+std::uint64_t basic_playout_t<N>::key(token_t to_move) const {
+    std::uint64_t k = hash_;
+    if (to_move == white)
+        k ^= white_to_move_key;
+    if (ko_ >= 0)
+        k ^= ko_key(ko_);
+    return k;
+}
+
+template class basic_playout_t<9>;
+template class basic_playout_t<13>;
+template class basic_playout_t<19>;
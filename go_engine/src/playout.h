@@ -0,0 +1,167 @@
+#ifndef ENGINE_PLAYOUT_H
+#define ENGINE_PLAYOUT_H
+
+#include <cstdint>
+#include <set>
+#include <utility>
+
+#include "misc.h"
+#include "token_t.h"
+
+template<int N> class basic_board_t;
+
+/**
+ * @brief cheap random number generator for playouts (xorshift64*)
+ */
+class fast_rng_t {
+  public:
+    explicit fast_rng_t(std::uint64_t seed = 42) : state_(seed ? seed : 0x9e3779b97f4a7c15ULL) {}
+
+    std::uint64_t next() {
+        state_ ^= state_ >> 12;
+        state_ ^= state_ << 25;
+        state_ ^= state_ >> 27;
+        return state_ * 2685821657736338717ULL;
+    }
+
+    /**
+     * @brief uniform integer in [0, n)
+     */
+    int uniform(int n) {
+        return (int)(((next() >> 32) * (std::uint64_t) n) >> 32);
+    }
+
+  private:
+    std::uint64_t state_;
+};
+
+/**
+ * @brief Light playouts (uniformly random moves until both players pass)
+ * @details A lean board for Monte Carlo rollouts: stones live on a padded (N+2)x(N+2) grid
+ *          with a border color, groups are circular lists of stones with pseudo-liberties
+ *          (number of adjacent stone/empty pairs), so playing a move never copies the board.
+ *          Pseudo-liberties are exact for the two questions a playout asks: does a group
+ *          lose its last liberty, and does it keep another liberty besides a given field.
+ *
+ *          Players choose uniformly among all legal moves which do not fill one of their own
+ *          eyes and pass if no such move exists. An eye is an empty field surrounded by own
+ *          stones (as in board_t::looks_like_an_eye) whose diagonals hold at most one opponent
+ *          stone (none at the edge), such that false eyes are filled.
+ *
+ *          Only simple ko is enforced, the hash history (super-ko) of board_t is ignored.
+ */
+template<int N>
+class basic_playout_t {
+  public:
+    static const int W = N + 2;
+
+    explicit basic_playout_t(std::uint64_t seed = 42);
+
+    /**
+     * @brief empty board
+     */
+    void clear();
+
+    /**
+     * @brief copy stones and ko of a board (groups and liberties are rebuilt)
+     */
+    void load(const basic_board_t<N> &b);
+
+    /**
+     * @brief test whether placing a token at pos is legal (simple ko, no suicide)
+     */
+    bool is_legal(coord_t pos, token_t tok) const;
+
+    /**
+     * @brief place a stone, remove captured stones
+     * @return false if the move is not legal (nothing changes)
+     */
+    bool play(coord_t pos, token_t tok);
+
+    /**
+     * @brief pass (lifts ko)
+     */
+    void pass();
+
+    /**
+     * @brief restart the random number generator (e.g. for copies of the same position)
+     */
+    void seed(std::uint64_t seed);
+
+    /**
+     * @brief play a random legal move which does not fill an own eye, pass otherwise
+     * @return position of the move or {-1, -1} for a pass
+     */
+    coord_t play_random(token_t tok);
+
+    /**
+     * @brief play random moves until both players passed in a row
+     *
+     * @param to_move player to move first
+     * @param max_moves stop after this many moves (passes included)
+     * @return number of moves played
+     */
+    int run(token_t to_move, int max_moves = 3 * N * N);
+
+    /**
+     * @brief did the last two moves pass?
+     */
+    bool finished() const;
+
+    /**
+     * @brief area score (Tromp-Taylor) from the view of black
+     * @details Stones plus empty regions which only reach stones of a single color.
+     *
+     * @param komi points of white
+     * @return black points - white points - komi
+     */
+    float score(float komi) const;
+
+    token_t token(coord_t pos) const;
+
+    /**
+     * @brief Zobrist hash of the stones on the board (table of board_t, captures are removed)
+     */
+    std::uint64_t hash() const;
+
+    /**
+     * @brief key of the position for transposition tables
+     * @details Zobrist hash of the stones combined with the player to move and the ko field.
+     */
+    std::uint64_t key(token_t to_move) const;
+
+  private:
+    static int index(int x, int y) { return (x + 1) * W + (y + 1); }
+
+    bool legal(int p, token_t tok) const;
+    bool is_eye(int p, token_t tok) const;
+    int adjacency(int p, int g) const;
+    void place(int p, token_t tok);
+    void merge(int a, int b);
+    void remove_group(int g);
+    void add_empty(int p);
+
+    /* stone colors (token_t, border outside of the board) */
+    std::uint8_t color_[W * W];
+    /* representative stone of the group of a stone (0 for empty fields) */
+    int group_[W * W];
+    /* next stone of the same group (circular list) */
+    int next_[W * W];
+    /* pseudo-liberties and stones by representative */
+    int libs_[W * W];
+    int size_[W * W];
+
+    /* unordered list of empty fields and position of each field within this list */
+    int empty_[N * N];
+    int empty_index_[W * W];
+    int num_empty_;
+
+    int ko_;
+    int passes_;
+    std::uint64_t hash_;
+    fast_rng_t rng_;
+};
+
+typedef basic_playout_t<19> playout_t;
+
+#endif
@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "policy_net.h"
+
+namespace {
+
+const int S = 19;
+const int P = S * S;
+
+/**
+ * @brief run f(0), ..., f(n - 1) on up to threads threads
+ */
+template<typename F>
+void parallel_for(int n, int threads, F f) {
+    threads = std::min(threads, n);
+    if (threads <= 1) {
+        for (int i = 0; i < n; ++i)
+            f(i);
+        return;
+    }
+    std::atomic<int> next(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.push_back(std::thread([&]() {
+            for (int i = next++; i < n; i = next++)
+                f(i);
+        }));
+    for (auto &&w : workers)
+        w.join();
+}
+
+/**
+ * @brief unfold a zero-padded CxSxS input into (C * k * k) x S * S columns
+ */
+void im2col(const float *input, int channels, int kernel, float *columns) {
+    const int pad = kernel / 2;
+    for (int c = 0; c < channels; ++c)
+        for (int dy = 0; dy < kernel; ++dy)
+            for (int dx = 0; dx < kernel; ++dx) {
+                float *col = columns + ((c * kernel + dy) * kernel + dx) * P;
+                const float *plane = input + c * P;
+                for (int y = 0; y < S; ++y) {
+                    const int sy = y + dy - pad;
+                    float *row = col + y * S;
+                    if (sy < 0 || sy >= S) {
+                        std::fill(row, row + S, 0.f);
+                        continue;
+                    }
+                    for (int x = 0; x < S; ++x) {
+                        const int sx = x + dx - pad;
+                        row[x] = (sx < 0 || sx >= S) ? 0.f : plane[sy * S + sx];
+                    }
+                }
+            }
+}
+
+// SIMD vectors (GCC/Clang vector extensions), 8 floats with AVX, 4 floats otherwise
+#if defined(__AVX__)
+typedef float vec_t __attribute__((vector_size(32)));
+#else
+typedef float vec_t __attribute__((vector_size(16)));
+#endif
+const int lanes = sizeof(vec_t) / sizeof(float);
+/* columns of C per work item (two vectors) */
+const int panel_cols = 2 * lanes;
+
+/**
+ * @brief ROWS rows of C = A x panel, the 2 x ROWS accumulators stay in registers
+ */
+template<int ROWS>
+void kernel(const float *a, const float *panel, int K, vec_t acc[][2]) {
+    for (int r = 0; r < ROWS; ++r)
+        acc[r][0] = acc[r][1] = vec_t{};
+    for (int k = 0; k < K; ++k) {
+        // unaligned loads, heap memory is not aligned to vectors before C++17
+        vec_t p0, p1;
+        std::memcpy(&p0, panel + k * panel_cols, sizeof(vec_t));
+        std::memcpy(&p1, panel + k * panel_cols + lanes, sizeof(vec_t));
+        for (int r = 0; r < ROWS; ++r) {
+            const float w = a[r * K + k];
+            acc[r][0] += w * p0;
+            acc[r][1] += w * p1;
+        }
+    }
+}
+
+/**
+ * @brief columns [j0, j0 + panel_cols) of C = act(A x B + bias), A: M x K, B: K x P, C: M x P
+ * @details The columns of B are packed into a contiguous panel first, which is then streamed
+ *          once for every 6 rows of C.
+ */
+void gemm_panel(const float *a, const float *b, const float *bias, bool relu, float *c,
+                int M, int K, int j0) {
+    const int n = std::min(panel_cols, P - j0);
+    std::vector<float> panel(K * panel_cols, 0.f);
+    for (int k = 0; k < K; ++k)
+        std::memcpy(&panel[k * panel_cols], b + k * P + j0, n * sizeof(float));
+
+    const int rows = 6;
+    vec_t acc[rows][2];
+    for (int m = 0; m < M; m += rows) {
+        const int r_end = std::min(rows, M - m);
+        switch (r_end) {
+            case 6: kernel<6>(a + m * K, panel.data(), K, acc); break;
+            case 5: kernel<5>(a + m * K, panel.data(), K, acc); break;
+            case 4: kernel<4>(a + m * K, panel.data(), K, acc); break;
+            case 3: kernel<3>(a + m * K, panel.data(), K, acc); break;
+            case 2: kernel<2>(a + m * K, panel.data(), K, acc); break;
+            default: kernel<1>(a + m * K, panel.data(), K, acc); break;
+        }
+        for (int r = 0; r < r_end; ++r) {
+            float values[panel_cols];
+            std::memcpy(values, acc[r], sizeof(values));
+            float *row = c + (m + r) * P + j0;
+            for (int q = 0; q < n; ++q) {
+                const float v = values[q] + bias[m + r];
+                row[q] = (relu && v < 0) ? 0.f : v;
+            }
+        }
+    }
+}
+
+template<typename T>
+bool read(std::ifstream &in, T *values, std::size_t n = 1) {
+    in.read(reinterpret_cast<char*>(values), n * sizeof(T));
+    return (bool) in;
+}
+
+}  // namespace
+
+
+policy_net_t::policy_net_t() : threads_(1) {}
+
+bool policy_net_t::load(const std::string &path) {
+    layers_.clear();
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) {
+        std::cerr << "cannot open weights " << path << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    std::int32_t version, num_layers;
+    if (!read(in, magic, 4) || std::memcmp(magic, "TFGO", 4) != 0 ||
+            !read(in, &version) || version != 1 || !read(in, &num_layers) || num_layers < 1) {
+        std::cerr << path << " is not a policy net export" << std::endl;
+        return false;
+    }
+
+    std::vector<layer_t> layers(num_layers);
+    for (int l = 0; l < num_layers; ++l) {
+        std::int32_t header[5];
+        if (!read(in, header, 5)) {
+            std::cerr << path << " is truncated" << std::endl;
+            return false;
+        }
+        layer_t &layer = layers[l];
+        layer.kernel = header[0];
+        layer.in = header[1];
+        layer.out = header[2];
+        layer.relu = (header[4] != 0);
+        if (layer.kernel < 1 || layer.kernel % 2 == 0 || layer.in < 1 || layer.out < 1 ||
+                (l > 0 && layer.in != layers[l - 1].out)) {
+            std::cerr << path << ": layer " << l << " has an invalid shape" << std::endl;
+            return false;
+        }
+
+        // HWIO -> out x (in * kernel * kernel)
+        const int k = layer.kernel;
+        const int K = layer.in * k * k;
+        std::vector<float> hwio(K * layer.out);
+        if (!read(in, hwio.data(), hwio.size())) {
+            std::cerr << path << " is truncated" << std::endl;
+            return false;
+        }
+        layer.weights.resize(layer.out * K);
+        for (int dy = 0; dy < k; ++dy)
+            for (int dx = 0; dx < k; ++dx)
+                for (int c = 0; c < layer.in; ++c)
+                    for (int o = 0; o < layer.out; ++o)
+                        layer.weights[o * K + (c * k + dy) * k + dx] =
+                            hwio[((dy * k + dx) * layer.in + c) * layer.out + o];
+
+        layer.bias.assign(layer.out, 0.f);
+        if (header[3] != 0 && !read(in, layer.bias.data(), layer.out)) {
+            std::cerr << path << " is truncated" << std::endl;
+            return false;
+        }
+    }
+
+    if (layers.back().out != 1) {
+        std::cerr << path << ": the last layer has to produce a single plane" << std::endl;
+        return false;
+    }
+    layers_.swap(layers);
+    return true;
+}
+
+bool policy_net_t::loaded() const {
+    return !layers_.empty();
+}
+
+int policy_net_t::planes() const {
+    return layers_.empty() ? 0 : layers_.front().in;
+}
+
+int policy_net_t::filters() const {
+    return layers_.empty() ? 0 : layers_.front().out;
+}
+
+void policy_net_t::set_threads(int threads) {
+    threads_ = std::max(1, threads);
+}
+
+void policy_net_t::convolve(const layer_t &layer, const float *input, int batch, float *output,
+                            float *columns) const {
+    const int K = layer.in * layer.kernel * layer.kernel;
+    const int panels = (P + panel_cols - 1) / panel_cols;
+
+    // as many positions at once as there are threads, such that the columns stay in the cache
+    for (int first = 0; first < batch; first += threads_) {
+        const int n = std::min(threads_, batch - first);
+        const float *in = input + first * layer.in * P;
+        float *out = output + first * layer.out * P;
+
+        // 1x1 convolutions use the input as columns
+        if (layer.kernel > 1)
+            parallel_for(n, threads_, [&](int b) {
+                im2col(in + b * layer.in * P, layer.in, layer.kernel, columns + b * K * P);
+            });
+
+        parallel_for(n * panels, threads_, [&](int item) {
+            const int b = item / panels;
+            const float *cols = (layer.kernel > 1) ? columns + b * K * P : in + b * layer.in * P;
+            gemm_panel(layer.weights.data(), cols, layer.bias.data(), layer.relu,
+                       out + b * layer.out * P, layer.out, K, (item % panels) * panel_cols);
+        });
+    }
+}
+
+void policy_net_t::forward(const float *input, int batch, float *logits) const {
+    if (layers_.empty() || batch < 1)
+        return;
+
+    int widest = 0, deepest = 0;
+    for (const layer_t &layer : layers_) {
+        widest = std::max(widest, layer.out);
+        deepest = std::max(deepest, layer.in * layer.kernel * layer.kernel);
+    }
+    std::vector<float> a(batch * widest * P), b(batch * widest * P);
+    std::vector<float> columns(std::min(batch, threads_) * deepest * P);
+
+    const float *current = input;
+    for (size_t l = 0; l < layers_.size(); ++l) {
+        float *next = (l + 1 == layers_.size()) ? logits : ((l % 2 == 0) ? a.data() : b.data());
+        convolve(layers_[l], current, batch, next, columns.data());
+        current = next;
+    }
+}
+
+void policy_net_t::forward(const int *input, int stride, int batch, float *logits) const {
+    const int C = planes();
+    std::vector<float> converted(batch * C * P);
+    for (int n = 0; n < batch; ++n)
+        for (int i = 0; i < C * P; ++i)
+            converted[n * C * P + i] = input[n * stride * P + i];
+    forward(converted.data(), batch, logits);
+}
+
+void policy_net_t::probabilities(const float *logits, int batch, float *prob) {
+    for (int row = 0; row < batch * S; ++row) {
+        const float *l = logits + row * S;
+        float *p = prob + row * S;
+        const float top = *std::max_element(l, l + S);
+        float total = 0;
+        for (int i = 0; i < S; ++i) {
+            p[i] = std::exp(l[i] - top);
+            total += p[i];
+        }
+        for (int i = 0; i < S; ++i)
+            p[i] /= total;
+    }
+}
+
+
+policy_net_backend_t::policy_net_backend_t(const policy_net_t *net, bool logits)
+    : net_(net), output_logits_(logits) {}
+
+int policy_net_backend_t::input_size() const {
+    return net_->planes() * P;
+}
+
+int policy_net_backend_t::output_size() const {
+    return P;
+}
+
+void policy_net_backend_t::evaluate(const float *inputs, int batch, float *outputs) {
+    if (output_logits_) {
+        net_->forward(inputs, batch, outputs);
+        return;
+    }
+    logits_.resize(batch * P);
+    net_->forward(inputs, batch, logits_.data());
+    policy_net_t::probabilities(logits_.data(), batch, outputs);
+}
+
+
+policy_net_gtp_policy_t::policy_net_gtp_policy_t(const policy_net_t *net) : net_(net) {}
+
+void policy_net_gtp_policy_t::evaluate(const int *planes, int size, token_t to_move, float *scores) {
+    if (size != S) {
+        fallback_.evaluate(planes, size, to_move, scores);
+        return;
+    }
+    // the planes of the net are the first ones of board_t::feature_planes
+    net_->forward(planes, 49, 1, scores);
+}
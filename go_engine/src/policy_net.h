@@ -0,0 +1,134 @@
+#ifndef ENGINE_POLICY_NET_H
+#define ENGINE_POLICY_NET_H
+
+#include <string>
+#include <vector>
+
+#include "eval_broker.h"
+#include "gtp_engine.h"
+
+/**
+ * @brief Native CPU inference of the policy network of tfgo.py (no TensorFlow needed)
+ * @details The network is a stack of zero-padded convolutions on 19x19 planes (NCHW): a 5x5
+ *          convolution, 11 3x3 convolutions with k filters and ReLU each, and a final 1x1
+ *          convolution with bias to a single plane of logits. Every convolution is computed as
+ *          im2col followed by a matrix product (weights x columns). The product packs panels of
+ *          columns and accumulates 6 rows x 2 SIMD vectors in registers (SSE, or AVX if the
+ *          compiler targets it, e.g. -march=native).
+ *
+ *          Weights are read from the binary export of export_weights.py (little endian):
+ *
+ *              "TFGO", int32 version (1), int32 number of layers, then per layer
+ *              int32 kernel, in, out, has_bias, relu,
+ *              float32 weights[kernel][kernel][in][out] (TensorFlow HWIO layout),
+ *              float32 bias[out] (if has_bias)
+ */
+class policy_net_t {
+  public:
+    policy_net_t();
+
+    /**
+     * @brief read weights of an export
+     * @return false if the file is missing or not a valid export (the net stays empty)
+     */
+    bool load(const std::string &path);
+
+    bool loaded() const;
+
+    /**
+     * @brief number of input planes (first planes of board_t::feature_planes)
+     */
+    int planes() const;
+
+    /**
+     * @brief number of filters k of the hidden layers
+     */
+    int filters() const;
+
+    /**
+     * @brief number of threads used by forward (positions and column panels are split)
+     */
+    void set_threads(int threads);
+
+    /**
+     * @brief logits of all fields for a batch of positions
+     * @details Can be called concurrently, all buffers are local.
+     *
+     * @param input batch x planes() x 19 x 19 values
+     * @param batch number of positions
+     * @param logits output batch x 19 x 19 values
+     */
+    void forward(const float *input, int batch, float *logits) const;
+
+    /**
+     * @brief same as above for the output of board_t::feature_planes
+     * @details Planes beyond planes() are ignored, hence stride gives the number of planes
+     *          per position of the input (e.g. 49).
+     */
+    void forward(const int *input, int stride, int batch, float *logits) const;
+
+    /**
+     * @brief softmax as in the exported graph ("probabilities")
+     * @details tf.nn.softmax of tfgo.py normalizes the last axis of the NCHW logits, i.e. each
+     *          row of 19 fields separately. Use this to compare with TensorFlow outputs.
+     */
+    static void probabilities(const float *logits, int batch, float *prob);
+
+  private:
+    struct layer_t {
+        int kernel;
+        int in;
+        int out;
+        bool relu;
+        /* out x (in * kernel * kernel), rows match the columns of im2col */
+        std::vector<float> weights;
+        /* out values (zeros without bias) */
+        std::vector<float> bias;
+    };
+
+    void convolve(const layer_t &layer, const float *input, int batch, float *output,
+                  float *columns) const;
+
+    std::vector<layer_t> layers_;
+    int threads_;
+};
+
+/**
+ * @brief backend for eval_broker_t, evaluates feature planes to logits or per-row probabilities
+ * @details Inputs are planes() x 19 x 19 values, outputs 19 x 19 values. The probabilities (see
+ *          policy_net_t::probabilities) are normalized per row, hence only the logits rank all
+ *          fields of a board, e.g. for move selection.
+ */
+class policy_net_backend_t : public eval_backend_t {
+  public:
+    /**
+     * @param net weights (not owned)
+     * @param logits output logits instead of the probabilities of the exported graph
+     */
+    explicit policy_net_backend_t(const policy_net_t *net, bool logits = false);
+
+    int input_size() const;
+    int output_size() const;
+    void evaluate(const float *inputs, int batch, float *outputs);
+
+  private:
+    const policy_net_t *net_;
+    bool output_logits_;
+    std::vector<float> logits_;
+};
+
+/**
+ * @brief genmove scores from the logits of the net on 19x19 boards, random scores otherwise
+ * @details Not thread-safe (random fallback), use one instance per engine.
+ */
+class policy_net_gtp_policy_t : public gtp_policy_t {
+  public:
+    explicit policy_net_gtp_policy_t(const policy_net_t *net);
+    void evaluate(const int *planes, int size, token_t to_move, float *scores);
+
+  private:
+    const policy_net_t *net_;
+    gtp_random_policy_t fallback_;
+};
+
+#endif
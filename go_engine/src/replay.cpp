@@ -0,0 +1,218 @@
+#include <algorithm>
+
+#include "token_t.h"
+#include "field_t.h"
+#include "group_t.h"
+#include "board_t.h"
+#include "history.h"
+#include "planestream.h"
+#include "score.h"
+#include "replay.h"
+
+namespace {
+
+/**
+ * @brief replay all actions before the requested position
+ * @param history records all positions if given
+ * @return index of the next action (num_actions if all moves were requested)
+ */
+int replay(const std::vector<move_t> &actions, const int moves, board_t &b,
+           token_t *to_move, history_t *history = nullptr) {
+
+    // GNUgo means: 0 -- all moves
+    // GNUgo means: 1 -- empty board
+    // GNUgo means: 2 -- first move (black)
+
+    const int num_actions = actions.size();
+
+    // black starts, if there is nothing to replay
+    token_t opponent_player = black;
+
+    // place all handicap stones
+    int offset = 0;
+    for (; offset < num_actions && actions[offset].kind == move_t::set; ++offset) {
+        b.play({actions[offset].row(), actions[offset].col()}, actions[offset].player());
+        opponent_player = b.opponent(actions[offset].player());
+    }
+    if (history != nullptr)
+        history->push(b);
+
+    // run game for at least 'moves' moves but stop early enough such that a last move remains open
+    int evaluate_until = std::min(offset + moves - 1, num_actions - 1);
+
+    // really all moves?
+    if(moves == 0)
+        evaluate_until = num_actions;
+
+    for (; offset < evaluate_until; offset++) {
+        const move_t &m = actions[offset];
+        opponent_player = b.opponent(m.player());
+
+        // set stones and moves are both placed on the board
+        if (m.kind != move_t::pass)
+            b.play({m.row(), m.col()}, m.player());
+        if (history != nullptr)
+            history->push(b);
+    }
+
+    // given the current situation, we switch to the view of the opponent (the play who's turn it is)
+    *to_move = opponent_player;
+    return evaluate_until;
+}
+
+/**
+ * @brief training label of an action (19 * column + row, -1 for passes)
+ */
+int label(const move_t &m) {
+    if (m.kind == move_t::pass)
+        return -1;
+    return 19 * m.col() + m.row();
+}
+
+}  // namespace
+
+int play_game(SGFbin *Game, int* data, const int moves) {
+    // decode entire game at once (bounds are checked here)
+    const std::vector<move_t> &actions = Game->moves();
+    const int num_actions = actions.size();
+
+    board_t b;
+    token_t to_move;
+    const int evaluate_until = replay(actions, moves, b, &to_move);
+    b.feature_planes(data, to_move);
+
+    // all moves are evaluated nothing to do
+    if(moves == 0)
+        return 0;
+
+    // there is no next move in this (truncated) game
+    if (evaluate_until < 0 || evaluate_until >= num_actions)
+        return -1;
+
+    // the ground-truth next move (passes are reported as 0 like before)
+    const move_t &next = actions[evaluate_until];
+    if (next.kind == move_t::pass)
+        return 0;
+    // std::cout << "next move << "<< next.row() << " : "<< next.col() << std::endl;
+    const int next_move = 19 * next.col() + next.row();
+    return next_move;
+}
+
+int play_game_labels(SGFbin *Game, int* data, const int moves,
+                     int* next_moves, const int k, int* outcome) {
+    const std::vector<move_t> &actions = Game->moves();
+    const int num_actions = actions.size();
+
+    board_t b;
+    token_t to_move;
+    const int evaluate_until = replay(actions, moves, b, &to_move);
+    b.feature_planes(data, to_move);
+
+    // the following k actions
+    for (int i = 0; i < k; ++i) {
+        const int j = evaluate_until + i;
+        if (moves != 0 && j >= 0 && j < num_actions) {
+            next_moves[3 * i + 0] = label(actions[j]);
+            next_moves[3 * i + 1] = actions[j].color;
+            next_moves[3 * i + 2] = actions[j].kind;
+        } else {
+            next_moves[3 * i + 0] = -1;
+            next_moves[3 * i + 1] = empty;
+            next_moves[3 * i + 2] = -1;
+        }
+    }
+
+    // result of the game (winner: 1 black, 2 white, 3 draw) from the view of the planes
+    const sgfbin_header_t &h = Game->header();
+    const bool known = (h.flags & sgfbin_header_t::has_result) && h.winner != 0;
+    int value = 0;
+    if (known && h.winner != 3)
+        value = ((h.winner == 1) == (to_move == black)) ? 1 : -1;
+    outcome[0] = known;
+    outcome[1] = value;
+    outcome[2] = (known && h.result == sgfbin_header_t::by_score) ? value * h.margin : 0;
+
+    if (moves == 0)
+        return 0;
+    if (evaluate_until < 0 || evaluate_until >= num_actions)
+        return -1;
+    const int next = label(actions[evaluate_until]);
+    return (next < 0) ? 0 : next;
+}
+
+int play_game_extended(SGFbin *Game, int* data, const int moves) {
+    const std::vector<move_t> &actions = Game->moves();
+    const int num_actions = actions.size();
+
+    board_t b;
+    token_t to_move;
+    const int evaluate_until = replay(actions, moves, b, &to_move);
+    b.feature_planes(data, to_move);
+    b.liberties_after_move_planes(data + 49 * 19 * 19, to_move);
+
+    if (moves == 0)
+        return 0;
+    if (evaluate_until < 0 || evaluate_until >= num_actions)
+        return -1;
+    const int next = label(actions[evaluate_until]);
+    return (next < 0) ? 0 : next;
+}
+
+int play_game_history(SGFbin *Game, int* data, const int moves) {
+    const std::vector<move_t> &actions = Game->moves();
+    const int num_actions = actions.size();
+
+    board_t b;
+    history_t history;
+    token_t to_move;
+    const int evaluate_until = replay(actions, moves, b, &to_move, &history);
+    history.feature_planes(data, to_move);
+
+    if (moves == 0)
+        return 0;
+    if (evaluate_until < 0 || evaluate_until >= num_actions)
+        return -1;
+    const int next = label(actions[evaluate_until]);
+    return (next < 0) ? 0 : next;
+}
+
+int play_game_stream(SGFbin *Game, std::vector<unsigned char> *stream, std::vector<int> *next_moves) {
+    const std::vector<move_t> &actions = Game->moves();
+    const int num_actions = actions.size();
+
+    board_t b;
+    token_t to_move = black;
+    int offset = 0;
+    for (; offset < num_actions && actions[offset].kind == move_t::set; ++offset) {
+        b.play({actions[offset].row(), actions[offset].col()}, actions[offset].player());
+        to_move = b.opponent(actions[offset].player());
+    }
+
+    plane_stream_encoder_t encoder;
+    std::vector<int> planes(49 * 19 * 19);
+    int frames = 0;
+    for (; offset < num_actions; ++offset) {
+        std::fill(planes.begin(), planes.end(), 0);
+        b.feature_planes(planes.data(), to_move);
+        encoder.encode(planes.data(), stream);
+        frames++;
+
+        const move_t &m = actions[offset];
+        if (next_moves != nullptr)
+            next_moves->push_back(std::max(0, label(m)));
+
+        to_move = b.opponent(m.player());
+        if (m.kind != move_t::pass)
+            b.play({m.row(), m.col()}, m.player());
+    }
+    return frames;
+}
+
+float play_game_score(SGFbin *Game, float komi, int *ownership, const int *dead) {
+    board_t b;
+    token_t to_move;
+    replay(Game->moves(), 0, b, &to_move);
+    if (dead != nullptr)
+        return territory_score(b, dead, komi, ownership);
+    return area_score(b, komi, ownership);
+}
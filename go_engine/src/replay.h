@@ -0,0 +1,90 @@
+#ifndef ENGINE_REPLAY_H
+#define ENGINE_REPLAY_H
+
+#include <vector>
+
+#include "sgfbin.h"
+
+/**
+ * @brief replay a game and compute the feature planes of a position
+ * @details Setup stones at the beginning are always placed. The planes are computed from the
+ *          perspective of the player who's turn it is.
+ *
+ * @param Game game to replay
+ * @param data output planes (49x19x19, must be zero-initialized)
+ * @param moves number of moves in match to the current position (0 means all moves)
+ * @return next move (19 * column + row, pass is 0) or -1 if there is no next move
+ */
+int play_game(SGFbin *Game, int* data, const int moves);
+
+/**
+ * @brief replay a game once and emit the planes together with several training targets
+ * @details Same position as play_game. Each row of next_moves is [label, color, kind] for one
+ *          of the following k actions with label = 19 * column + row (-1 for passes), color as
+ *          token_t and kind as move_t::kind_t. Rows beyond the end of the game are [-1, 0, -1].
+ *          The outcome is [known, value, margin] from the perspective of the player to move,
+ *          value is 1 (win), -1 (loss) or 0 (draw, unknown) and margin the score difference in
+ *          half points (0 if the game was not scored). Only version 2 files know the outcome.
+ *
+ * @param Game game to replay
+ * @param data output planes (49x19x19, must be zero-initialized)
+ * @param moves number of moves in match to the current position (as in play_game)
+ * @param next_moves output array of k rows (3 ints each)
+ * @param k number of future actions
+ * @param outcome output array of 3 ints
+ * @return next move exactly like play_game
+ */
+int play_game_labels(SGFbin *Game, int* data, const int moves,
+                     int* next_moves, const int k, int* outcome);
+
+/**
+ * @brief replay a game and compute the feature planes plus "liberties after move"
+ * @details Planes 0-48 are the same as in play_game, planes 49-56 are the liberties of the
+ *          own group after playing at a field (1, 2, ..., 7, more than 7).
+ *
+ * @param Game game to replay
+ * @param data output planes (57x19x19, must be zero-initialized)
+ * @param moves number of moves in match to the current position (as in play_game)
+ * @return next move exactly like play_game
+ */
+int play_game_extended(SGFbin *Game, int* data, const int moves);
+
+/**
+ * @brief replay a game and compute the AlphaGo Zero history planes of a position
+ * @details Alternative feature set to play_game, see history_t. The last positions are
+ *          recorded while replaying, no additional replays are necessary.
+ *
+ * @param Game game to replay
+ * @param data output planes (17x19x19, must be zero-initialized)
+ * @param moves number of moves in match to the current position (as in play_game)
+ * @return next move exactly like play_game
+ */
+int play_game_history(SGFbin *Game, int* data, const int moves);
+
+/**
+ * @brief replay a game once and delta encode the feature planes of all positions
+ * @details Emits one frame (see plane_stream_encoder_t) for every position which has a next
+ *          action, i.e. the positions of play_game(Game, data, m) for m = 1, 2, ... in order.
+ *          Decode with plane_stream_decoder_t.
+ *
+ * @param Game game to replay
+ * @param stream frames are appended here
+ * @param next_moves if given, the next move of each frame is appended (as play_game)
+ * @return number of frames
+ */
+int play_game_stream(SGFbin *Game, std::vector<unsigned char> *stream, std::vector<int> *next_moves = nullptr);
+
+/**
+ * @brief replay a complete game and score the final position
+ * @details Area score (Tromp-Taylor, see area_score) if no dead stones are given, otherwise the
+ *          territory estimate (see territory_score) including the captures of the game.
+ *
+ * @param Game game to replay
+ * @param komi points of white
+ * @param ownership if given, 19x19 values (1: black, -1: white, 0: neutral)
+ * @param dead if given, 19x19 values (non-zero for dead stones of the final position)
+ * @return black points - white points - komi
+ */
+float play_game_score(SGFbin *Game, float komi, int *ownership = nullptr, const int *dead = nullptr);
+
+#endif
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <vector>
+
+#include "score.h"
+#include "board_t.h"
+
+namespace {
+
+/**
+ * @brief owner of each field by flood fill over empty regions
+ * @details owner is 1 (black), -1 (white) or 0 (neutral) for every field, empty fields get the
+ *          owner of their region
+ *
+ * @param black_points number of fields owned by black (stones + empty fields)
+ * @param white_points number of fields owned by white (stones + empty fields)
+ */
+template<int N>
+void regions(const int *colors, int *owner, int *black_points, int *white_points) {
+    std::vector<int> stack, region;
+    std::vector<bool> visited(N * N, false);
+    *black_points = 0;
+    *white_points = 0;
+
+    for (int p = 0; p < N * N; ++p) {
+        if (colors[p] != empty) {
+            owner[p] = (colors[p] == black) ? 1 : -1;
+            *black_points += (colors[p] == black);
+            *white_points += (colors[p] == white);
+            continue;
+        }
+        if (visited[p])
+            continue;
+
+        // collect the empty region and the colors it reaches
+        bool reaches_black = false, reaches_white = false;
+        region.clear();
+        stack.push_back(p);
+        visited[p] = true;
+        while (!stack.empty()) {
+            const int q = stack.back();
+            stack.pop_back();
+            region.push_back(q);
+
+            const int x = q / N;
+            const int y = q % N;
+            const int neighbors[4][2] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+            for (int k = 0; k < 4; ++k) {
+                if (!valid_pos(neighbors[k][0]) || !valid_pos(neighbors[k][1]))
+                    continue;
+                const int r = map2line(neighbors[k][0], neighbors[k][1]);
+                if (colors[r] == black)
+                    reaches_black = true;
+                else if (colors[r] == white)
+                    reaches_white = true;
+                else if (!visited[r]) {
+                    visited[r] = true;
+                    stack.push_back(r);
+                }
+            }
+        }
+
+        const int value = (reaches_black == reaches_white) ? 0 : (reaches_black ? 1 : -1);
+        for (int q : region)
+            owner[q] = value;
+        if (value == 1)
+            *black_points += region.size();
+        if (value == -1)
+            *white_points += region.size();
+    }
+}
+
+template<int N>
+void colors_of(const basic_board_t<N> &b, int *colors) {
+    for (int x = 0; x < N; ++x)
+        for (int y = 0; y < N; ++y)
+            colors[map2line(x, y)] = b.fields[x][y].token();
+}
+
+}  // namespace
+
+
+template<int N>
+float area_score(const int *colors, float komi, int *ownership) {
+    int owner[N * N];
+    int black_points, white_points;
+    regions<N>(colors, owner, &black_points, &white_points);
+    if (ownership != nullptr)
+        std::copy(owner, owner + N * N, ownership);
+    return black_points - white_points - komi;
+}
+
+template<int N>
+float area_score(const basic_board_t<N> &b, float komi, int *ownership) {
+    int colors[N * N];
+    colors_of(b, colors);
+    return area_score<N>(colors, komi, ownership);
+}
+
+template<int N>
+float territory_score(const basic_board_t<N> &b, const int *dead, float komi, int *ownership) {
+    int colors[N * N];
+    colors_of(b, colors);
+
+    // remove dead stones, they are prisoners of the opponent
+    float prisoners_black = b.score_black;
+    float prisoners_white = b.score_white;
+    for (int p = 0; p < N * N; ++p) {
+        if (colors[p] == empty || !dead[p])
+            continue;
+        if (colors[p] == white)
+            prisoners_black++;
+        else
+            prisoners_white++;
+        colors[p] = empty;
+    }
+
+    int owner[N * N];
+    int black_points, white_points;
+    regions<N>(colors, owner, &black_points, &white_points);
+
+    // territory are the owned empty fields only
+    int territory_black = 0, territory_white = 0;
+    for (int p = 0; p < N * N; ++p) {
+        if (colors[p] != empty)
+            continue;
+        territory_black += (owner[p] == 1);
+        territory_white += (owner[p] == -1);
+    }
+
+    if (ownership != nullptr)
+        std::copy(owner, owner + N * N, ownership);
+    return (territory_black + prisoners_black) - (territory_white + prisoners_white) - komi;
+}
+
+template float area_score<9>(const int *colors, float komi, int *ownership);
+template float area_score<13>(const int *colors, float komi, int *ownership);
+template float area_score<19>(const int *colors, float komi, int *ownership);
+template float area_score<9>(const basic_board_t<9> &b, float komi, int *ownership);
+template float area_score<13>(const basic_board_t<13> &b, float komi, int *ownership);
+template float area_score<19>(const basic_board_t<19> &b, float komi, int *ownership);
+template float territory_score<9>(const basic_board_t<9> &b, const int *dead, float komi, int *ownership);
+template float territory_score<13>(const basic_board_t<13> &b, const int *dead, float komi, int *ownership);
+template float territory_score<19>(const basic_board_t<19> &b, const int *dead, float komi, int *ownership);
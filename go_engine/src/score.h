@@ -0,0 +1,49 @@
+#ifndef ENGINE_SCORE_H
+#define ENGINE_SCORE_H
+
+#include <set>
+#include <utility>
+
+#include "misc.h"
+#include "token_t.h"
+
+template<int N> class basic_board_t;
+
+/**
+ * @brief area score (Tromp-Taylor) of a position
+ * @details Each player gets a point for every own stone and for every empty field of a region
+ *          which only reaches own stones. Regions reaching both colors (dame) or no stone at
+ *          all (empty board) are neutral. All stones on the board count as alive.
+ *
+ * @param colors NxN values (token_t, row major as board_t::fields)
+ * @param komi points of white
+ * @param ownership if given, NxN values (1: black, -1: white, 0: neutral)
+ * @return black points - white points - komi
+ */
+template<int N>
+float area_score(const int *colors, float komi, int *ownership = nullptr);
+
+/**
+ * @brief area score (Tromp-Taylor) of a board (see above)
+ */
+template<int N>
+float area_score(const basic_board_t<N> &b, float komi, int *ownership = nullptr);
+
+/**
+ * @brief territory score (Japanese-style estimate) of a board given the dead stones
+ * @details Dead stones are removed and added to the prisoners of the opponent, who already
+ *          holds the stones captured during the game (board_t::score_black, score_white).
+ *          Territory are the empty fields of regions which only reach stones of one color.
+ *          Seki is not detected, i.e. eyes of groups in seki are counted as territory.
+ *
+ * @param b final position
+ * @param dead NxN values (non-zero for dead stones)
+ * @param komi points of white
+ * @param ownership if given, NxN values (1: black, -1: white, 0: neutral), dead stones belong
+ *        to the opponent
+ * @return black territory + prisoners - white territory - prisoners - komi
+ */
+template<int N>
+float territory_score(const basic_board_t<N> &b, const int *dead, float komi, int *ownership = nullptr);
+
+#endif
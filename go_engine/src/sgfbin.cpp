@@ -1,23 +1,250 @@
 // Author: Patrick Wieschollek <mail@patwie.com>
 
+#include <algorithm>
 #include <fstream>
 
 #include "sgfbin.h"
 
-SGFbin::SGFbin(std::string path) {
+namespace {
+
+void put16(unsigned char *dest, int value) {
+    dest[0] = (unsigned char)(value & 0xff);
+    dest[1] = (unsigned char)((value >> 8) & 0xff);
+}
+
+int get16(const unsigned char *src) {
+    return (int)(std::int16_t)(src[0] | (src[1] << 8));
+}
+
+}  // namespace
+
+
+void sgfbin_header_t::encode(unsigned char *dest, const unsigned char *moves, int len) {
+    dest[0] = 'S'; dest[1] = 'G'; dest[2] = 'F'; dest[3] = 'B';
+    dest[4] = (unsigned char) version2;
+    dest[5] = (unsigned char) board_size;
+    dest[6] = (unsigned char) flags;
+    dest[7] = (unsigned char) handicap;
+    put16(dest + 8, komi);
+    dest[10] = (unsigned char) winner;
+    dest[11] = (unsigned char) result;
+    put16(dest + 12, margin);
+    dest[14] = (unsigned char) rank_black;
+    dest[15] = (unsigned char) rank_white;
+    put16(dest + 16, year);
+    dest[18] = (unsigned char) month;
+    dest[19] = (unsigned char) day;
+
+    version = version2;
+    checksum = fnv1a(dest, moves, len);
+    for (int i = 0; i < 4; ++i)
+        dest[20 + i] = (unsigned char)((checksum >> (8 * i)) & 0xff);
+}
+
+bool sgfbin_header_t::decode(const unsigned char *buffer, int len) {
+    if (len < length)
+        return false;
+    if (buffer[0] != 'S' || buffer[1] != 'G' || buffer[2] != 'F' || buffer[3] != 'B')
+        return false;
+
+    version = buffer[4];
+    board_size = buffer[5];
+    flags = buffer[6];
+    handicap = buffer[7];
+    komi = get16(buffer + 8);
+    winner = buffer[10];
+    result = buffer[11];
+    margin = get16(buffer + 12);
+    rank_black = buffer[14];
+    rank_white = buffer[15];
+    year = get16(buffer + 16) & 0xffff;
+    month = buffer[18];
+    day = buffer[19];
+    checksum = 0;
+    for (int i = 0; i < 4; ++i)
+        checksum |= (std::uint32_t) buffer[20 + i] << (8 * i);
+    return true;
+}
+
+std::uint32_t sgfbin_header_t::fnv1a(const unsigned char *header, const unsigned char *moves, int len) {
+    std::uint32_t h = 2166136261U;
+    for (int i = 0; i < 20; ++i)
+        h = (h ^ header[i]) * 16777619U;
+    for (int i = 0; i < len; ++i)
+        h = (h ^ moves[i]) * 16777619U;
+    return h;
+}
+
+int sgfbin_header_t::parse_rank(const std::string &rank) {
+    // e.g. "9p", "3d", "12k", "1 dan" (everything else is unknown)
+    int value = 0;
+    size_t i = 0;
+    while (i < rank.size() && rank[i] >= '0' && rank[i] <= '9')
+        value = 10 * value + (rank[i++] - '0');
+    while (i < rank.size() && rank[i] == ' ')
+        i++;
+    if (value == 0 || i == rank.size())
+        return 0;
+
+    switch (rank[i]) {
+    case 'k': case 'K':
+        return (value <= 30) ? rank_kyu + 31 - value : 0;
+    case 'd': case 'D':
+        return (value <= 9) ? rank_dan + value : 0;
+    case 'p': case 'P':
+        return (value <= 9) ? rank_pro + value : 0;
+    }
+    return 0;
+}
+
+
+SGFbin::SGFbin(std::string path) : is_decoded_(false), compressed_(false), valid_(true) {
     moves_ = read_moves(path.c_str());
+    raw_ = (const unsigned char*) moves_.data();
+    len_ = moves_.size();
+    read_header();
 }
 
 
-SGFbin::SGFbin(unsigned char* buffer, int len) {
+SGFbin::SGFbin(unsigned char* buffer, int len) : is_decoded_(false), compressed_(false), valid_(true) {
     moves_.assign(buffer, buffer + len);
+    raw_ = (const unsigned char*) moves_.data();
+    len_ = moves_.size();
+    read_header();
+}
+
+
+SGFbin::SGFbin(const unsigned char* buffer, int len, bool borrow)
+    : raw_(buffer), len_(len), is_decoded_(false), compressed_(false), valid_(true) {
+    if (!borrow) {
+        moves_.assign(buffer, buffer + len);
+        raw_ = (const unsigned char*) moves_.data();
+    }
+    read_header();
+}
+
+SGFbin::SGFbin(const SGFbin &other)
+    : moves_(other.moves_), raw_(other.raw_), len_(other.len_), decoded_(other.decoded_),
+      is_decoded_(other.is_decoded_), decoder_(other.decoder_), compressed_(other.compressed_),
+      header_(other.header_), valid_(other.valid_) {
+    rebase(other);
+}
+
+SGFbin& SGFbin::operator=(const SGFbin &other) {
+    if (this != &other) {
+        moves_ = other.moves_;
+        raw_ = other.raw_;
+        len_ = other.len_;
+        decoded_ = other.decoded_;
+        is_decoded_ = other.is_decoded_;
+        decoder_ = other.decoder_;
+        compressed_ = other.compressed_;
+        header_ = other.header_;
+        valid_ = other.valid_;
+        rebase(other);
+    }
+    return *this;
+}
+
+void SGFbin::rebase(const SGFbin &other) {
+    const unsigned char *begin = (const unsigned char*) other.moves_.data();
+    if (other.raw_ != nullptr && !other.moves_.empty() &&
+        other.raw_ >= begin && other.raw_ <= begin + other.moves_.size())
+        raw_ = (const unsigned char*) moves_.data() + (other.raw_ - begin);
+}
+
+void SGFbin::read_header() {
+    if (!header_.decode(raw_, len_))
+        return;
+
+    const int len = len_ - sgfbin_header_t::length;
+    if (sgfbin_header_t::fnv1a(raw_, raw_ + sgfbin_header_t::length, len) != header_.checksum) {
+        std::cerr << "checksum of SGFbin does not match" << std::endl;
+        valid_ = false;
+    }
+    raw_ += sgfbin_header_t::length;
+    len_ -= sgfbin_header_t::length;
+
+    if (header_.flags & sgfbin_header_t::compressed) {
+        // moves are decoded on demand while replaying the game
+        compressed_ = true;
+        if (!decoder_.reset(raw_, len_)) {
+            std::cerr << "SGFbin contains more moves than its stream can hold" << std::endl;
+            valid_ = false;
+        }
+        moves_.clear();
+        raw_ = nullptr;
+        len_ = 0;
+    }
+}
+
+void SGFbin::inflate(unsigned int step) {
+    if (!compressed_)
+        return;
+    const unsigned int until = std::min(step + 1, decoder_.num_actions());
+    while (moves_.size() < 2 * until) {
+        const std::uint16_t value = decoder_.next();
+        moves_.push_back((char)(value >> 8));
+        moves_.push_back((char)(value & 0xff));
+    }
+    raw_ = (const unsigned char*) moves_.data();
+    len_ = moves_.size();
+}
+
+const sgfbin_header_t& SGFbin::header() const {
+    return header_;
+}
+
+const bool SGFbin::valid() const {
+    return valid_;
+}
+
+const std::vector<move_t>& SGFbin::moves() {
+    if (is_decoded_)
+        return decoded_;
+    is_decoded_ = true;
+
+    const unsigned int n = num_actions();
+    inflate(n);
+    decoded_.resize(n);
+
+    // branch-free such that the compiler can vectorize this loop
+    const unsigned char *raw = raw_;
+    const int size = std::min(header_.board_size, 19);
+    int off_board = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+        const int value = (raw[2 * i] << 8) | raw[2 * i + 1];
+        const int x = value & 31;
+        const int y = (value >> 5) & 31;
+        const int is_pass = (value >> 12) & 1;
+        const int is_move = (value >> 11) & 1;
+        const int outside = ((x >= size) | (y >= size)) & (is_pass ^ 1);
+        const int no_point = is_pass | outside;
+
+        off_board |= outside;
+        decoded_[i].point = (std::int16_t)((y * 19 + x) * (1 - no_point) - no_point);
+        decoded_[i].color = (std::uint8_t)(black - ((value >> 10) & 1));
+        decoded_[i].kind = (std::uint8_t)(is_move * (1 - no_point) + move_t::pass * no_point);
+    }
+
+    if (off_board) {
+        std::cerr << "SGFbin contains moves outside of the board" << std::endl;
+        valid_ = false;
+    }
+    return decoded_;
+}
+
+const unsigned int SGFbin::flags(unsigned int step) {
+    inflate(step);
+    return (raw_[2 * step] << 8) & 0xe000;
 }
 
 
 void SGFbin::parse(unsigned int step,
                    int *x, int *y, bool *is_white,
                    bool *is_move, bool *is_pass) {
-    parse((unsigned char)moves_[2 * step],(unsigned char)moves_[2 * step + 1],
+    inflate(step);
+    parse(raw_[2 * step], raw_[2 * step + 1],
            x, y, 
            is_white, is_move, is_pass);
 }
@@ -26,7 +253,8 @@ void SGFbin::debug(unsigned int step) {
     int x=0, y=0;
     bool is_white=false, is_move=false, is_pass=false;
 
-    parse((unsigned char)moves_[2 * step],(unsigned char)moves_[2 * step + 1],
+    inflate(step);
+    parse(raw_[2 * step], raw_[2 * step + 1],
            &x, &y, 
            &is_white, &is_move, &is_pass);
 
@@ -66,7 +294,8 @@ void SGFbin::parse(unsigned char m1, unsigned char m2,
 
     // std::cout << "decode "<< byte1 << " " << byte2 << std::endl;
       
-    int value = (byte1 << 8) + byte2;
+    // the upper three bits are flags and do not belong to the move
+    int value = ((byte1 << 8) + byte2) & 0x1fff;
     // int value = byte2 * 256 + byte1;
     // std::cout << "value "<< value << std::endl;
       
@@ -90,7 +319,9 @@ void SGFbin::parse(unsigned char m1, unsigned char m2,
 
 
 const unsigned int SGFbin::num_actions() const {
-    return moves_.size() / 2;
+    if (compressed_)
+        return decoder_.num_actions();
+    return len_ / 2;
 }
 
 
@@ -98,11 +329,15 @@ void SGFbin::ascii() {
     int x = 0, y = 0;
     bool is_move = true, is_white = true, is_pass = true;
     std::cout << "(;" << "GM[1]" << std::endl;
-    std::cout << "SZ[19]" << std::endl;
+    std::cout << "SZ[" << header_.board_size << "]" << std::endl;
+    if (header_.version == sgfbin_header_t::version2)
+        std::cout << "KM[" << (header_.komi / 2.f) << "]" << std::endl;
+
+    inflate(num_actions());
 
 
-    for (unsigned int i = 0; i < moves_.size(); i += 2) {
-        parse((unsigned char)moves_[i], (unsigned char)moves_[i + 1],
+    for (unsigned int i = 0; i + 1 < len_; i += 2) {
+        parse(raw_[i], raw_[i + 1],
                &x, &y, 
                &is_white, &is_move, &is_pass);
         if (is_move) {
@@ -3,10 +3,113 @@
 #ifndef ENGINE_SGFBIN_H
 #define ENGINE_SGFBIN_H
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <string>
 
+#include "movecoder.h"
+#include "token_t.h"
+
+/**
+ * @brief Fixed size header of SGFbin version 2 files
+ * @details All multi-byte values are little endian. The header starts with the magic "SGFB",
+ *          which never collides with the first byte of a headerless (version 1) file,
+ *          since the upper three bits of a move are always zero there.
+ *
+ *    offset  size
+ *         0     4   magic "SGFB"
+ *         4     1   version (2)
+ *         5     1   board size
+ *         6     1   flags (see below)
+ *         7     1   handicap stones
+ *         8     2   komi in half points (signed)
+ *        10     1   winner (0: unknown, 1: black, 2: white, 3: draw)
+ *        11     1   how the game ended (0: score, 1: resign, 2: time, 3: forfeit)
+ *        12     2   winning margin in half points (only for scored games)
+ *        14     1   rank of black player
+ *        15     1   rank of white player
+ *        16     2   year
+ *        18     1   month
+ *        19     1   day
+ *        20     4   checksum (FNV-1a over header bytes 0-19 and all moves)
+ *
+ *    Ranks are ordered: 0 unknown, 30k..1k -> 1..30, 1d..9d -> 31..39, 1p..9p -> 41..49.
+ */
+struct sgfbin_header_t {
+    static const int length = 24;
+    static const int version2 = 2;
+
+    // header flags
+    static const int has_result = 1;
+    static const int amateur = 2;
+    static const int compressed = 4;
+
+    // reserved bits of a single move (---pmcyyyyyxxxxx)
+    static const int move_by_winner = 8192;
+
+    static const int rank_kyu = 0;
+    static const int rank_dan = 30;
+    static const int rank_pro = 40;
+
+    enum result_type { by_score = 0, by_resign = 1, by_time = 2, by_forfeit = 3 };
+
+    int version = 1;
+    int board_size = 19;
+    int flags = 0;
+    int handicap = 0;
+    int komi = 0;
+    int winner = 0;
+    int result = by_score;
+    int margin = 0;
+    int rank_black = 0;
+    int rank_white = 0;
+    int year = 0;
+    int month = 0;
+    int day = 0;
+    std::uint32_t checksum = 0;
+
+    /**
+     * @brief write header into 'length' bytes and compute checksum of header+moves
+     */
+    void encode(unsigned char *dest, const unsigned char *moves, int len);
+
+    /**
+     * @brief read header from buffer
+     * @return false if buffer does not start with a version 2 header
+     */
+    bool decode(const unsigned char *buffer, int len);
+
+    /**
+     * @brief compute checksum of encoded header bytes and moves
+     */
+    static std::uint32_t fnv1a(const unsigned char *header, const unsigned char *moves, int len);
+
+    /**
+     * @brief convert SGF ranks like "9p", "3d", "12k" to the ordered representation
+     */
+    static int parse_rank(const std::string &rank);
+};
+
+/**
+ * @brief A single decoded action of a game
+ * @details point is the board index 19 * row + column (row from SGF "y", column from SGF "x"),
+ *          which is the field {point / 19, point % 19} of board_t. Passes have point -1.
+ *          The stride is 19 for all board sizes, such that row() and col() are also the field
+ *          of smaller boards (basic_board_t<9>, basic_board_t<13>).
+ */
+struct move_t {
+    enum kind_t { set = 0, move = 1, pass = 2 };
+
+    std::int16_t point;
+    std::uint8_t color;
+    std::uint8_t kind;
+
+    const token_t player() const { return (token_t) color; }
+    const int row() const { return point / 19; }
+    const int col() const { return point % 19; }
+};
+
 /**
  * @brief Reader for binary SGF files
  * @details It seems to be easier to load a binary version of GO-specific SGF files
@@ -30,6 +133,35 @@ class SGFbin {
      */
     SGFbin(unsigned char* buffer, int len);
 
+    /**
+     * @brief use SGFbin from a buffer which is owned by someone else
+     * @details This avoids any copy, e.g. for records in a memory mapped LMDB database.
+     *          The buffer has to outlive this object.
+     *
+     * @param buffer containing the moves from binary SGFfile
+     * @param len length of buffer
+     * @param borrow do not copy the buffer
+     */
+    SGFbin(const unsigned char* buffer, int len, bool borrow);
+
+    /**
+     * @brief copies own their buffer if the original does, borrowed buffers stay borrowed
+     */
+    SGFbin(const SGFbin &other);
+    SGFbin& operator=(const SGFbin &other);
+    SGFbin(SGFbin &&other) = default;
+    SGFbin& operator=(SGFbin &&other) = default;
+
+    /**
+     * @brief meta information of the game (all defaults for headerless files)
+     */
+    const sgfbin_header_t& header() const;
+
+    /**
+     * @brief false if the checksum of a version 2 file does not match or moves are off board
+     */
+    const bool valid() const;
+
     /**
      * @brief read move from SGFbin description
      *
@@ -54,7 +186,7 @@ class SGFbin {
      *    c: is white ? [1:yes, 0:no] (0 means black ;-) )
      *    y: encoded row (1-19)
      *    x: encoded column (a-s)
-     *    -: free bits (maybe we can store something useful here, current sun position or illuminati-code?)
+     *    -: flags (version 2, see sgfbin_header_t), ignored for decoding the position
      */
     void parse(unsigned char m1, unsigned char m2,
                         int *x, int *y, 
@@ -65,6 +197,20 @@ class SGFbin {
      */
     const unsigned int num_actions() const;
 
+    /**
+     * @brief all actions of the game, decoded once on first use
+     * @details Prefer this over calling parse() for each step. Actions with a position outside
+     *          of the board (see sgfbin_header_t::board_size) are stored as passes and make the
+     *          game invalid (see valid()).
+     *          A trailing odd byte of a truncated buffer is ignored.
+     */
+    const std::vector<move_t>& moves();
+
+    /**
+     * @brief flags stored in the reserved bits of a move (e.g. sgfbin_header_t::move_by_winner)
+     */
+    const unsigned int flags(unsigned int step);
+
     /**
      * @brief reconstruct plain ASCII version of SGF file (only important things)
      */
@@ -76,7 +222,33 @@ class SGFbin {
      * @param filename path to SGFbin file
      */
     std::vector<char> read_moves(char const* filename);
+
+    /**
+     * @brief skip a version 2 header if present
+     */
+    void read_header();
+
+    /**
+     * @brief decode compressed moves until (including) step
+     */
+    void inflate(unsigned int step);
+
+    /**
+     * @brief point raw_ into the own moves_ if other views its own moves_
+     */
+    void rebase(const SGFbin &other);
+
+    /* owned moves (copy of the buffer or decompressed moves) */
     std::vector<char> moves_;
+    /* view of all moves (either into moves_ or a borrowed buffer) */
+    const unsigned char *raw_;
+    size_t len_;
+    std::vector<move_t> decoded_;
+    bool is_decoded_;
+    move_decoder_t decoder_;
+    bool compressed_;
+    sgfbin_header_t header_;
+    bool valid_;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+
+#include "misc.h"
+#include "sgfreader.h"
+
+namespace {
+
+// same list as in data/reader.py (including the undocumented keys found in the data)
+const std::set<std::string> valid_keys = {
+    "B", "KO", "MN", "W",
+    "AB", "AE", "AW", "PL",
+    "C", "DM", "GB", "GW", "HO", "N", "UC", "V",
+    "BM", "DO", "IT", "TE",
+    "AR", "CR", "DD", "LB", "LN", "MA", "SL", "SQ", "TR",
+    "AP", "CA", "FF", "GM", "ST", "SZ",
+    "AN", "BR", "BT", "CP", "DT", "EV", "GN", "GC", "ON", "OT", "PB", "PC", "PW", "RE", "RO", "RU", "SO", "TM", "US", "WR", "WT",
+    "BL", "OB", "OW", "WL",
+    "FG", "PM", "VW",
+    "KM", "OH", "HA", "MULTIGOGM", "BC", "WC"
+};
+
+std::string strip(const std::string &s) {
+    const char *ws = " \t\n\r";
+    const size_t start = s.find_first_not_of(ws);
+    if (start == std::string::npos)
+        return "";
+    const size_t end = s.find_last_not_of(ws);
+    return s.substr(start, end - start + 1);
+}
+
+std::string lower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), ::tolower);
+    return s;
+}
+
+bool has(const std::string &haystack, const char *needle) {
+    return lower(haystack).find(needle) != std::string::npos;
+}
+
+}  // namespace
+
+
+SGFreader::SGFreader(std::string path) : valid_(false), amateur_(false) {
+    std::ifstream ifs(path.c_str(), std::ios::binary | std::ios::in);
+    if (!ifs) {
+        std::cerr << "cannot read " << path << std::endl;
+        return;
+    }
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    parse(content.data(), content.size());
+}
+
+SGFreader::SGFreader(const char* buffer, int len) : valid_(false), amateur_(false) {
+    parse(buffer, len);
+}
+
+void SGFreader::parse(const char* buffer, int len) {
+    const char *needle = "amateur";
+    const int needle_len = strlen(needle);
+
+    std::string key, last_key, value;
+    int depth = 0;
+    bool opened = false;
+    bool in_value = false;
+    bool escaped = false;
+
+    // "amateur" is searched in the entire content, like in data/reader.py
+    for (int i = 0; i + needle_len <= len && !amateur_; ++i) {
+        int j = 0;
+        while (j < needle_len && ::tolower(buffer[i + j]) == needle[j])
+            j++;
+        amateur_ = (j == needle_len);
+    }
+
+    valid_ = true;
+
+    for (int i = 0; i < len; ++i) {
+        const char c = buffer[i];
+
+        if (in_value) {
+            if (escaped) {
+                // soft line break "\<newline>" is removed entirely
+                if (c != '\n' && c != '\r')
+                    value += c;
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == ']') {
+                in_value = false;
+                // treat single-key multi value 'AB[dp][pd][pp]'
+                if (key.empty())
+                    key = last_key;
+                property(key, strip(value));
+                last_key = key;
+                key.clear();
+                value.clear();
+            } else {
+                value += c;
+            }
+            continue;
+        }
+
+        if (c == '(') {
+            opened = true;
+            depth++;
+        } else if (c == ')') {
+            // the first closing bracket ends the main line (the first child is always taken),
+            // everything afterwards are siblings or further games in a collection
+            break;
+        } else if (c == ';') {
+            key.clear();
+        } else if (c == '[') {
+            in_value = true;
+            value.clear();
+        } else if (depth > 0 && c >= 'A' && c <= 'Z') {
+            key += c;
+        }
+        // lower case letters in identifiers are ignored (FF[3]), whitespace as well
+    }
+
+    // a missing final ')' is tolerated, a value which is cut off is not
+    if (!opened || in_value)
+        valid_ = false;
+}
+
+void SGFreader::property(const std::string &key, const std::string &value) {
+    if (!contains(valid_keys, key)) {
+        std::cerr << key << " is not a valid key" << std::endl;
+        valid_ = false;
+        return;
+    }
+
+    if (key == "KO")
+        std::cerr << "illegal move (KO property)" << std::endl;
+
+    // play move (W, B) or set stone (AW, AB)
+    if (key == "B" || key == "W" || key == "AB" || key == "AW") {
+        // "B[]" is a pass in FF[4], empty setup properties carry nothing
+        if (value.empty() && (key == "AB" || key == "AW"))
+            return;
+        actions.push_back({key, value});
+        return;
+    }
+
+    if (!value.empty())
+        info_[key] = value;
+}
+
+const bool SGFreader::valid() const {
+    return valid_;
+}
+
+const bool SGFreader::correct() const {
+    if (info("SZ") != "19")
+        return false;
+    if (has(info("GC"), "illegal"))
+        return false;
+    if (has(info("GC"), "corrupt"))
+        return false;
+    if (has(info("RE"), "time"))
+        return false;
+    if (has(info("RE"), "resign"))
+        return false;
+    return true;
+}
+
+const bool SGFreader::amateur() const {
+    return amateur_;
+}
+
+const std::string SGFreader::info(const std::string &key) const {
+    auto it = info_.find(key);
+    if (it == info_.end())
+        return "";
+    return it->second;
+}
+
+sgfbin_header_t SGFreader::header() const {
+    sgfbin_header_t h;
+
+    const std::string size = info("SZ");
+    h.board_size = size.empty() ? 19 : atoi(size.c_str());
+    h.komi = (int) std::lround(2 * atof(info("KM").c_str()));
+    h.rank_black = sgfbin_header_t::parse_rank(info("BR"));
+    h.rank_white = sgfbin_header_t::parse_rank(info("WR"));
+
+    // handicap from HA or the number of black setup stones
+    h.handicap = atoi(info("HA").c_str());
+    if (info("HA").empty()) {
+        int stones = 0;
+        for (auto &&action : actions)
+            if (action.first == "AB")
+                stones++;
+        h.handicap = (stones > 1) ? stones : 0;
+    }
+
+    // result like "B+R", "W+2.5", "B+Resign", "W+T", "0", "Draw", "Jigo"
+    const std::string re = lower(info("RE"));
+    if (re == "0" || has(re, "draw") || has(re, "jigo")) {
+        h.winner = 3;
+    } else if (!re.empty() && (re[0] == 'b' || re[0] == 'w')) {
+        h.winner = (re[0] == 'b') ? 1 : 2;
+        const std::string how = (re.size() > 2 && re[1] == '+') ? re.substr(2) : "";
+        if (!how.empty() && how[0] == 'r')
+            h.result = sgfbin_header_t::by_resign;
+        else if (!how.empty() && how[0] == 't')
+            h.result = sgfbin_header_t::by_time;
+        else if (!how.empty() && how[0] == 'f')
+            h.result = sgfbin_header_t::by_forfeit;
+        else
+            h.margin = (int) std::lround(2 * atof(how.c_str()));
+    }
+    if (h.winner != 0)
+        h.flags |= sgfbin_header_t::has_result;
+    if (amateur_)
+        h.flags |= sgfbin_header_t::amateur;
+
+    // date like "2017-05-27" (further dates or ranges are ignored)
+    const std::string dt = info("DT");
+    if (dt.size() >= 4)
+        h.year = atoi(dt.substr(0, 4).c_str());
+    if (dt.size() >= 7 && dt[4] == '-')
+        h.month = atoi(dt.substr(5, 2).c_str());
+    if (dt.size() >= 10 && dt[7] == '-')
+        h.day = atoi(dt.substr(8, 2).c_str());
+
+    return h;
+}
+
+std::vector<unsigned char> SGFreader::sgfbin(bool with_header, bool compressed) const {
+    // encoding:  ---pmcyyyyyxxxxx (see docs/FILEFORMAT.md)
+    std::vector<unsigned char> bin;
+    bin.reserve(2 * actions.size());
+
+    sgfbin_header_t h = header();
+    with_header = with_header || compressed;
+
+    for (auto &&action : actions) {
+        const std::string &k = action.first;
+        const std::string &v = action.second;
+
+        const bool is_set = (k == "AB" || k == "AW");
+        const bool is_white = (k == "W" || k == "AW");
+
+        int value = 0;
+        if (v.empty() || lower(v) == "tt") {
+            value = 4096;
+        } else if (v.size() != 2) {
+            std::cerr << "cannot parse " << v << std::endl;
+            continue;
+        } else {
+            const int x = ::tolower(v[0]) - 'a';
+            const int y = ::tolower(v[1]) - 'a';
+            value = 32 * y + x;
+            if (!is_set)
+                value += 2048;
+        }
+        if (is_white)
+            value += 1024;
+        if (with_header && (h.winner == 1 || h.winner == 2) && (h.winner == 2) == is_white)
+            value += sgfbin_header_t::move_by_winner;
+
+        bin.push_back((unsigned char)((value >> 8) & 0xff));
+        bin.push_back((unsigned char)(value & 0xff));
+    }
+
+    if (compressed) {
+        h.flags |= sgfbin_header_t::compressed;
+        bin = move_encoder_t::compress(bin.data(), bin.size());
+    }
+
+    if (with_header) {
+        std::vector<unsigned char> dest(sgfbin_header_t::length);
+        h.encode(dest.data(), bin.data(), bin.size());
+        bin.insert(bin.begin(), dest.begin(), dest.end());
+    }
+    return bin;
+}
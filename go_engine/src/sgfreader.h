@@ -0,0 +1,85 @@
+#ifndef ENGINE_SGFREADER_H
+#define ENGINE_SGFREADER_H
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sgfbin.h"
+
+/**
+ * @brief Streaming reader for plain ASCII SGF files
+ * @details This is the C++ counterpart of SGFReader from data/reader.py. The input
+ *          is consumed in a single pass without building a game tree. Only the main
+ *          line is kept, i.e. for each variation the first child is followed and all
+ *          siblings are ignored. Properties B, W, AB, AW are collected as actions,
+ *          all other known properties end up as meta information.
+ */
+class SGFreader {
+  public:
+    /**
+     * @brief read ASCII SGF file given filename
+     *
+     * @param path path to SGF file
+     */
+    SGFreader(std::string path);
+
+    /**
+     * @brief read ASCII SGF from a buffer
+     *
+     * @param buffer content of SGF file
+     * @param len length of buffer
+     */
+    SGFreader(const char* buffer, int len);
+
+    /**
+     * @brief was the content parsed without errors (unknown keys, unbalanced brackets)?
+     */
+    const bool valid() const;
+
+    /**
+     * @brief same heuristic as SGFMeta.correct in data/reader.py
+     * @details board size must be 19, no illegal or corrupt game comments and
+     *          no games decided by time or resignation
+     */
+    const bool correct() const;
+
+    /**
+     * @brief is this a game between amateurs (the file mentions "amateur" somewhere)?
+     */
+    const bool amateur() const;
+
+    /**
+     * @brief return meta information (e.g. "PB", "KM", "RE") or an empty string
+     */
+    const std::string info(const std::string &key) const;
+
+    /**
+     * @brief collect meta information (komi, result, ranks, ...) for a SGFbin version 2 header
+     */
+    sgfbin_header_t header() const;
+
+    /**
+     * @brief encode all actions into the 2-bytes-per-move SGFbin format
+     * @details see docs/FILEFORMAT.md, actions which cannot be parsed are skipped
+     *          exactly like the python converter does
+     *
+     * @param with_header write version 2 (header + flags in reserved bits)
+     * @param compressed entropy code the moves (implies version 2, see move_encoder_t)
+     */
+    std::vector<unsigned char> sgfbin(bool with_header = false, bool compressed = false) const;
+
+    /* all actions (key, value) in order of appearance, key is one of B, W, AB, AW */
+    std::vector<std::pair<std::string, std::string> > actions;
+
+  private:
+    void parse(const char* buffer, int len);
+    void property(const std::string &key, const std::string &value);
+
+    std::map<std::string, std::string> info_;
+    bool valid_;
+    bool amateur_;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "thread_pool.h"
+
+
+thread_pool_t::thread_pool_t(int threads) : stopping_(false) {
+    for (int t = 0; t < std::max(1, threads); ++t)
+        workers_.push_back(std::thread(&thread_pool_t::work, this));
+}
+
+thread_pool_t::~thread_pool_t() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+    for (auto &&w : workers_)
+        w.join();
+}
+
+void thread_pool_t::post(task_t task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+    }
+    wakeup_.notify_one();
+}
+
+void thread_pool_t::run(int tasks, const std::function<void(int)> &task) {
+    struct state_t {
+        std::atomic<int> next;
+        int done;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    std::shared_ptr<state_t> state = std::make_shared<state_t>();
+    state->next = 0;
+    state->done = 0;
+
+    // helpers which start after all tasks were claimed return without touching task
+    auto claim = [state, tasks, &task]() {
+        int completed = 0;
+        for (int i = state->next++; i < tasks; i = state->next++) {
+            task(i);
+            completed++;
+        }
+        if (completed == 0)
+            return;
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->done += completed;
+        if (state->done == tasks)
+            state->finished.notify_all();
+    };
+
+    const int helpers = std::min(tasks - 1, size());
+    for (int h = 0; h < helpers; ++h)
+        post(claim);
+    claim();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&]() { return state->done >= tasks; });
+}
+
+int thread_pool_t::size() const {
+    return workers_.size();
+}
+
+void thread_pool_t::work() {
+    while (true) {
+        task_t task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeup_.wait(lock, [&]() { return stopping_ || !queue_.empty(); });
+            if (queue_.empty())
+                return;
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef ENGINE_THREAD_POOL_H
+#define ENGINE_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed number of worker threads which execute posted tasks in FIFO order
+ * @details Destroying the pool executes all queued tasks before the workers stop.
+ *          run() splits a single job into tasks, e.g. the rows of a board.
+ */
+class thread_pool_t {
+  public:
+    typedef std::function<void()> task_t;
+
+    explicit thread_pool_t(int threads);
+    ~thread_pool_t();
+
+    /**
+     * @brief queue a task, it runs on one of the workers
+     */
+    void post(task_t task);
+
+    /**
+     * @brief execute task(0), ..., task(tasks - 1) and wait until all of them finished
+     * @details The calling thread executes tasks as well, hence a call from a worker of this
+     *          pool cannot deadlock and a pool of n workers computes with up to n + 1 threads.
+     *          Tasks are claimed in order but might run in any order and concurrently.
+     */
+    void run(int tasks, const std::function<void(int)> &task);
+
+    /**
+     * @brief number of workers
+     */
+    int size() const;
+
+  private:
+    void work();
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::deque<task_t> queue_;
+    bool stopping_;
+    std::vector<std::thread> workers_;
+};
+
+#endif
@@ -0,0 +1,144 @@
+#include "transposition.h"
+
+
+template<int N>
+basic_transposition_table_t<N>::basic_transposition_table_t(std::size_t capacity)
+    : entries_(nullptr), capacity_(bucket_size), generation_(1),
+      lookups_(0), hits_(0), stores_(0), replacements_(0) {
+    while (capacity_ < capacity)
+        capacity_ <<= 1;
+    entries_ = new entry_t[capacity_];
+    clear();
+}
+
+template<int N>
+basic_transposition_table_t<N>::~basic_transposition_table_t() {
+    delete[] entries_;
+}
+
+template<int N>
+void basic_transposition_table_t<N>::clear() {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+        entries_[i].sequence.store(0);
+        entries_[i].generation.store(0);
+        entries_[i].key.store(0);
+        entries_[i].value.store(0.f);
+        for (int j = 0; j < num_priors; ++j)
+            entries_[i].priors[j].store(0.f);
+    }
+    generation_ = 1;
+    lookups_ = 0;
+    hits_ = 0;
+    stores_ = 0;
+    replacements_ = 0;
+}
+
+template<int N>
+bool basic_transposition_table_t<N>::lookup(std::uint64_t key, float *value, float *priors) {
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    entry_t *bucket = entries_ + (key & (capacity_ - 1) & ~(std::size_t) (bucket_size - 1));
+
+    for (int i = 0; i < bucket_size; ++i) {
+        entry_t &e = bucket[i];
+        const std::uint32_t before = e.sequence.load(std::memory_order_acquire);
+        if ((before & 1) || e.generation.load(std::memory_order_relaxed) == 0 ||
+                e.key.load(std::memory_order_relaxed) != key)
+            continue;
+
+        *value = e.value.load(std::memory_order_relaxed);
+        for (int j = 0; j < num_priors; ++j)
+            priors[j] = e.priors[j].load(std::memory_order_relaxed);
+
+        // the entry might have been replaced while reading
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (e.sequence.load(std::memory_order_relaxed) != before)
+            return false;
+
+        // keep entries in use alive
+        e.generation.store(generation_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+template<int N>
+bool basic_transposition_table_t<N>::store(std::uint64_t key, float value, const float *priors) {
+    stores_.fetch_add(1, std::memory_order_relaxed);
+    entry_t *bucket = entries_ + (key & (capacity_ - 1) & ~(std::size_t) (bucket_size - 1));
+
+    // same position, otherwise an unused entry, otherwise the oldest one
+    entry_t *victim = nullptr;
+    std::uint32_t oldest = 0;
+    for (int i = 0; i < bucket_size; ++i) {
+        entry_t &e = bucket[i];
+        const std::uint32_t generation = e.generation.load(std::memory_order_relaxed);
+        if (generation != 0 && e.key.load(std::memory_order_relaxed) == key) {
+            victim = &e;
+            break;
+        }
+        if (victim == nullptr || generation < oldest) {
+            victim = &e;
+            oldest = generation;
+        }
+    }
+
+    std::uint32_t sequence = victim->sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) || !victim->sequence.compare_exchange_strong(sequence, sequence + 1,
+                                                                    std::memory_order_relaxed))
+        return false;
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (victim->generation.load(std::memory_order_relaxed) != 0 &&
+            victim->key.load(std::memory_order_relaxed) != key)
+        replacements_.fetch_add(1, std::memory_order_relaxed);
+
+    victim->key.store(key, std::memory_order_relaxed);
+    victim->generation.store(generation_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    victim->value.store(value, std::memory_order_relaxed);
+    for (int j = 0; j < num_priors; ++j)
+        victim->priors[j].store(priors[j], std::memory_order_relaxed);
+
+    victim->sequence.store(sequence + 2, std::memory_order_release);
+    return true;
+}
+
+template<int N>
+void basic_transposition_table_t<N>::new_generation() {
+    generation_.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<int N>
+std::size_t basic_transposition_table_t<N>::capacity() const {
+    return capacity_;
+}
+
+template<int N>
+std::uint64_t basic_transposition_table_t<N>::lookups() const {
+    return lookups_;
+}
+
+template<int N>
+std::uint64_t basic_transposition_table_t<N>::hits() const {
+    return hits_;
+}
+
+template<int N>
+std::uint64_t basic_transposition_table_t<N>::stores() const {
+    return stores_;
+}
+
+template<int N>
+std::uint64_t basic_transposition_table_t<N>::replacements() const {
+    return replacements_;
+}
+
+template<int N>
+float basic_transposition_table_t<N>::hit_rate() const {
+    const std::uint64_t n = lookups_;
+    return (n == 0) ? 0.f : (float) hits_ / n;
+}
+
+template class basic_transposition_table_t<9>;
+template class basic_transposition_table_t<13>;
+template class basic_transposition_table_t<19>;
@@ -0,0 +1,91 @@
+#ifndef ENGINE_TRANSPOSITION_H
+#define ENGINE_TRANSPOSITION_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Lock-free table of position evaluations (priors + value) shared by search threads
+ * @details Positions are identified by a 64bit key (see basic_playout_t::key, which combines
+ *          the Zobrist hash of the stones, the player to move and the ko field). The table has
+ *          a fixed number of entries, grouped into buckets of 4 entries. A key is stored in
+ *          the bucket given by its lower bits. If the bucket is full, the entry of the oldest
+ *          generation is replaced, hence entries of earlier searches (see new_generation) make
+ *          room first.
+ *
+ *          Every entry is guarded by a sequence counter (seqlock): a writer makes it odd while
+ *          writing and even afterwards, a reader reports a miss if the counter was odd or
+ *          changed while reading. A writer gives up if another thread writes the same entry.
+ *          All fields are atomics, so no operation blocks or waits.
+ */
+template<int N>
+class basic_transposition_table_t {
+  public:
+    enum { bucket_size = 4, num_priors = N * N + 1 };
+
+    /**
+     * @param capacity number of entries (rounded up to a power of two, at least one bucket)
+     */
+    explicit basic_transposition_table_t(std::size_t capacity = 1 << 16);
+    ~basic_transposition_table_t();
+
+    /**
+     * @brief look up the evaluation of a position
+     *
+     * @param key key of the position
+     * @param value output value of the position
+     * @param priors output num_priors values
+     * @return true if the position was found (otherwise the outputs are undefined)
+     */
+    bool lookup(std::uint64_t key, float *value, float *priors);
+
+    /**
+     * @brief insert (or overwrite) the evaluation of a position
+     * @return false if the entry was written by another thread at the same time
+     */
+    bool store(std::uint64_t key, float value, const float *priors);
+
+    /**
+     * @brief mark all present entries as old (e.g. when a new search starts)
+     */
+    void new_generation();
+
+    /**
+     * @brief remove all entries and reset the counters
+     * @details Must not run concurrently with other methods.
+     */
+    void clear();
+
+    std::size_t capacity() const;
+
+    std::uint64_t lookups() const;
+    std::uint64_t hits() const;
+    std::uint64_t stores() const;
+    /* stores which evicted the entry of another position */
+    std::uint64_t replacements() const;
+    float hit_rate() const;
+
+  private:
+    struct entry_t {
+        std::atomic<std::uint32_t> sequence;
+        /* 0 for unused entries */
+        std::atomic<std::uint32_t> generation;
+        std::atomic<std::uint64_t> key;
+        std::atomic<float> value;
+        std::atomic<float> priors[num_priors];
+    };
+
+    entry_t *entries_;
+    std::size_t capacity_;
+    std::atomic<std::uint32_t> generation_;
+
+    std::atomic<std::uint64_t> lookups_;
+    std::atomic<std::uint64_t> hits_;
+    std::atomic<std::uint64_t> stores_;
+    std::atomic<std::uint64_t> replacements_;
+};
+
+typedef basic_transposition_table_t<19> transposition_table_t;
+
+#endif
@@ -0,0 +1,317 @@
+// Standalone training data feeder. Samples random positions from a game corpus, computes the
+// feature planes, applies the dihedral augmentation and writes ready minibatches into a
+// shared-memory ring buffer, which python maps as numpy arrays (go_engine/python/feeder.py).
+//
+//   feeder <corpus> [--shm /tfgo_feeder] [--batch 128] [--slots 8] [--threads N]
+//                   [--seed 42] [--symmetries 8|1] [--report 5]
+//
+// <corpus> is a directory of *.sgfbin files, a packed corpus (sgf2bin --pack) or a LMDB
+// database (go_db.py --action create). Games from LMDB are read in place from its memory map.
+//
+// A batch has the same layout as GameDecoder+DihedralGroup+BatchData in go_db.py:
+//     feature_planes  int32 [batch, symmetries * 49, 19, 19]
+//     labels          int32 [batch, symmetries]
+//     labels_2d       int32 [batch, symmetries, 19, 19]
+// With "--symmetries 1" a single random transformation is applied to each position.
+//
+// Shared memory layout (all values little endian, see feeder_header_t):
+//     [header, 4096 bytes][sequence numbers, 64 bytes per slot][slots, 4096 byte aligned]
+// Slot i is free for ticket t (t % slots == i) if its sequence number is t and holds the
+// batch of ticket t if the sequence number is t + 1. The consumer releases a slot by setting
+// its sequence number to t + slots. Producers draw tickets from an atomic counter.
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/corpus.h"
+#include "../src/sgfbin.h"
+#include "../src/replay.h"
+#include "sgflmdb.h"
+
+const int num_planes = 49;
+const int board_size = 19;
+const int area = board_size * board_size;
+const size_t header_bytes = 4096;
+const size_t seq_stride = 64;
+
+struct feeder_header_t {
+    char magic[8];                              // "TFGOFEED"
+    std::uint32_t version;                      // 1
+    std::uint32_t slots;
+    std::uint32_t batch_size;
+    std::uint32_t symmetries;
+    std::uint32_t planes;
+    std::uint32_t board;
+    std::uint64_t slot_bytes;
+    std::uint64_t data_offset;                  // offset of first slot
+    std::uint64_t seq_offset;                   // offset of sequence numbers
+    alignas(64) std::atomic<std::uint64_t> write_ticket;
+    alignas(64) std::atomic<std::uint64_t> batches;         // produced batches
+    std::atomic<std::uint64_t> producer_stalls; // producer waited for a free slot
+    alignas(64) std::uint64_t consumer_stalls;  // written by the consumer
+    std::uint64_t consumed;                     // written by the consumer
+};
+
+static_assert(sizeof(feeder_header_t) <= header_bytes, "header too large");
+
+std::atomic<bool> running(true);
+
+void stop(int) {
+    running = false;
+}
+
+/**
+ * @brief transform a point by one of the 8 elements of D4 (same order as DihedralGroup)
+ * @details version 2k is np.rot90(x, k), version 2k+1 is np.rot90(x[:, ::-1, :], k)
+ */
+inline void transform(int version, int r, int c, int *rr, int *cc) {
+    if (version & 1)
+        r = board_size - 1 - r;
+    for (int k = 0; k < version / 2; ++k) {
+        const int t = r;
+        r = board_size - 1 - c;
+        c = t;
+    }
+    *rr = r;
+    *cc = c;
+}
+
+/**
+ * @brief write one sample (all requested symmetries) into its place of the batch
+ */
+void write_sample(const int *planes, int next_move, const std::vector<int> &versions,
+                  std::int32_t *dst_planes, std::int32_t *dst_labels, std::int32_t *dst_labels_2d) {
+    const int row = next_move % board_size;
+    const int col = next_move / board_size;
+
+    // index map for all points once per version
+    int map[area];
+    for (size_t v = 0; v < versions.size(); ++v) {
+        for (int r = 0; r < board_size; ++r)
+            for (int c = 0; c < board_size; ++c) {
+                int rr, cc;
+                transform(versions[v], r, c, &rr, &cc);
+                map[r * board_size + c] = rr * board_size + cc;
+            }
+
+        std::int32_t *out = dst_planes + v * num_planes * area;
+        for (int p = 0; p < num_planes; ++p)
+            for (int i = 0; i < area; ++i)
+                out[p * area + map[i]] = planes[p * area + i];
+
+        int rr, cc;
+        transform(versions[v], row, col, &rr, &cc);
+        dst_labels[v] = board_size * cc + rr;
+        std::int32_t *label_2d = dst_labels_2d + v * area;
+        std::fill(label_2d, label_2d + area, 0);
+        label_2d[rr * board_size + cc] = 1;
+    }
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <corpus> [--shm /tfgo_feeder] [--batch 128] [--slots 8]"
+                  << " [--threads N] [--seed 42] [--symmetries 8|1] [--report 5]" << std::endl;
+        return 1;
+    }
+
+    std::string shm_name = "/tfgo_feeder";
+    int batch_size = 128;
+    int slots = 8;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int seed = 42;
+    int symmetries = 8;
+    int report = 5;
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        const std::string key = argv[i];
+        if (key == "--shm")
+            shm_name = argv[i + 1];
+        else if (key == "--batch")
+            batch_size = std::max(1, atoi(argv[i + 1]));
+        else if (key == "--slots")
+            slots = std::max(2, atoi(argv[i + 1]));
+        else if (key == "--threads")
+            num_threads = std::max(1, atoi(argv[i + 1]));
+        else if (key == "--seed")
+            seed = atoi(argv[i + 1]);
+        else if (key == "--symmetries")
+            symmetries = (atoi(argv[i + 1]) == 1) ? 1 : 8;
+        else if (key == "--report")
+            report = std::max(1, atoi(argv[i + 1]));
+    }
+
+    const std::string path = argv[1];
+    const bool use_lmdb = path.size() > 5 && path.compare(path.size() - 5, 5, ".lmdb") == 0;
+    std::unique_ptr<SGFcorpus> corpus;
+    std::unique_ptr<SGFlmdb> db;
+    if (use_lmdb)
+        db.reset(new SGFlmdb(path));
+    else
+        corpus.reset(new SGFcorpus(path));
+    const size_t num_games = use_lmdb ? db->size() : corpus->size();
+    std::cout << "loaded " << num_games << " games" << std::endl;
+    if (num_games == 0)
+        return 1;
+
+    // layout of shared memory
+    const size_t sample_ints = symmetries * (num_planes * area + 1 + area);
+    const size_t slot_bytes = ((batch_size * sample_ints * 4 + 4095) / 4096) * 4096;
+    const size_t seq_bytes = ((slots * seq_stride + 4095) / 4096) * 4096;
+    const size_t total = header_bytes + seq_bytes + slots * slot_bytes;
+
+    int fd = shm_open(shm_name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+    if (fd < 0 || ftruncate(fd, total) != 0) {
+        std::cerr << "cannot create shared memory " << shm_name << std::endl;
+        return 1;
+    }
+    unsigned char *base = (unsigned char*) mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "cannot map shared memory " << shm_name << std::endl;
+        return 1;
+    }
+
+    feeder_header_t *header = new (base) feeder_header_t();
+    header->version = 1;
+    header->slots = slots;
+    header->batch_size = batch_size;
+    header->symmetries = symmetries;
+    header->planes = num_planes;
+    header->board = board_size;
+    header->slot_bytes = slot_bytes;
+    header->seq_offset = header_bytes;
+    header->data_offset = header_bytes + seq_bytes;
+    header->write_ticket = 0;
+    header->batches = 0;
+    header->producer_stalls = 0;
+    header->consumer_stalls = 0;
+    header->consumed = 0;
+
+    std::vector<std::atomic<std::uint64_t>*> seq(slots);
+    for (int i = 0; i < slots; ++i) {
+        seq[i] = new (base + header_bytes + i * seq_stride) std::atomic<std::uint64_t>(i);
+    }
+
+    // the magic is written last, readers wait for it
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header->magic, "TFGOFEED", 8);
+
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+
+    auto worker = [&](int id) {
+        std::mt19937_64 rng(seed + id);
+        std::vector<int> planes(num_planes * area);
+        std::vector<int> versions(symmetries);
+        std::unique_ptr<SGFlmdb::reader_t> reader(use_lmdb ? new SGFlmdb::reader_t(*db) : nullptr);
+
+        while (running) {
+            const std::uint64_t ticket = header->write_ticket++;
+            std::atomic<std::uint64_t> &s = *seq[ticket % slots];
+
+            // wait until the consumer released this slot
+            bool stalled = false;
+            while (running && s.load(std::memory_order_acquire) != ticket) {
+                stalled = true;
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            if (!running)
+                break;
+            if (stalled)
+                header->producer_stalls++;
+
+            std::int32_t *slot = (std::int32_t*)(base + header->data_offset + (ticket % slots) * slot_bytes);
+            std::int32_t *dst_planes = slot;
+            std::int32_t *dst_labels = dst_planes + batch_size * symmetries * num_planes * area;
+            std::int32_t *dst_labels_2d = dst_labels + batch_size * symmetries;
+
+            for (int b = 0; b < batch_size;) {
+                int len = 0;
+                const unsigned char *raw = nullptr;
+                if (use_lmdb) {
+                    if (!reader->game(rng() % num_games, &raw, &len))
+                        continue;
+                } else {
+                    raw = corpus->game(rng() % num_games, &len);
+                }
+                SGFbin game(raw, len, true);
+
+                // game is too short -> skip (same as GameDecoder)
+                const int max_moves = game.num_actions();
+                if (!game.valid() || max_moves < 10)
+                    continue;
+                const int move_id = 2 + rng() % (max_moves - 4);
+
+                std::fill(planes.begin(), planes.end(), 0);
+                const int next_move = play_game(&game, planes.data(), move_id);
+                if (next_move < 0)
+                    continue;
+
+                if (symmetries == 8)
+                    for (int v = 0; v < 8; ++v)
+                        versions[v] = v;
+                else
+                    versions[0] = rng() % 8;
+
+                write_sample(planes.data(), next_move, versions,
+                             dst_planes + b * symmetries * num_planes * area,
+                             dst_labels + b * symmetries,
+                             dst_labels_2d + b * symmetries * area);
+                b++;
+            }
+
+            s.store(ticket + 1, std::memory_order_release);
+            header->batches++;
+            if (use_lmdb)
+                reader->refresh();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+        threads.push_back(std::thread(worker, t));
+
+    std::cout << "writing batches of " << batch_size << " into " << shm_name << " (" << slots
+              << " slots, " << (total >> 20) << " MB) using " << num_threads << " threads" << std::endl;
+
+    std::uint64_t last_batches = 0;
+    auto last = std::chrono::steady_clock::now();
+    while (running) {
+        for (int i = 0; i < 10 * report && running; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const auto now = std::chrono::steady_clock::now();
+        const double secs = std::chrono::duration<double>(now - last).count();
+        const std::uint64_t batches = header->batches;
+        const double rate = (batches - last_batches) / secs;
+        std::cout << rate << " batches/s, " << rate * batch_size << " positions/s, "
+                  << "produced " << batches << ", consumed " << header->consumed << ", "
+                  << "producer stalls " << header->producer_stalls << ", "
+                  << "consumer stalls " << header->consumer_stalls << std::endl;
+        last_batches = batches;
+        last = now;
+    }
+
+    // unblock and stop all workers
+    for (auto &&t : threads)
+        t.join();
+    munmap(base, total);
+    shm_unlink(shm_name.c_str());
+    return 0;
+}
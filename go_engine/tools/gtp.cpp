@@ -0,0 +1,48 @@
+// Native GTP engine, talks GTP on stdin/stdout and keeps the game state itself.
+//
+//   gtp [--weights tfgo.bin] [--threads N] [--feature-threads N]
+//
+// With weights (see export_weights.py) genmove plays the legal move with the highest logit of
+// the policy net on 19x19 boards, otherwise (and on smaller boards) a random legal move.
+// --threads is used by the net, --feature-threads by the feature planes of each genmove.
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/gtp_engine.h"
+#include "../src/policy_net.h"
+
+int main(int argc, char const *argv[]) {
+    std::string weights;
+    int threads = 1, feature_threads = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--weights") && i + 1 < argc) {
+            weights = argv[++i];
+        } else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--feature-threads") && i + 1 < argc) {
+            feature_threads = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--weights tfgo.bin] [--threads N]"
+                      << " [--feature-threads N]" << std::endl;
+            return 1;
+        }
+    }
+
+    policy_net_t net;
+    std::unique_ptr<gtp_policy_t> policy;
+    if (!weights.empty()) {
+        if (!net.load(weights))
+            return 1;
+        net.set_threads(threads);
+        policy.reset(new policy_net_gtp_policy_t(&net));
+    }
+
+    gtp_engine_t engine(policy.get());
+    engine.set_feature_threads(feature_threads);
+    engine.run(std::cin, std::cout);
+    return 0;
+}
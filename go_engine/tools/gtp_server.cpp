@@ -0,0 +1,81 @@
+// Multi-game GTP server, every connection to the Unix socket is an independent GTP session.
+//
+//   gtp_server --socket /tmp/tfgo.sock [--weights tfgo.bin] [--threads N] [--workers N]
+//              [--batch N] [--wait-us N]
+//
+// genmove of all sessions is evaluated in common batches of the policy net (see
+// export_weights.py), without weights it plays random legal moves. Stop with Ctrl-C.
+
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "../src/eval_broker.h"
+#include "../src/gtp_server.h"
+#include "../src/policy_net.h"
+
+gtp_server_t *server = nullptr;
+
+void handle_signal(int) {
+    if (server != nullptr)
+        server->stop();
+}
+
+int main(int argc, char const *argv[]) {
+    std::string path, weights;
+    int threads = 1, workers = 16, batch = 16, wait_us = 2000;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--socket") && i + 1 < argc) {
+            path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--weights") && i + 1 < argc) {
+            weights = argv[++i];
+        } else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--workers") && i + 1 < argc) {
+            workers = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--batch") && i + 1 < argc) {
+            batch = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--wait-us") && i + 1 < argc) {
+            wait_us = std::atoi(argv[++i]);
+        } else {
+            path.clear();
+            break;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "usage: " << argv[0] << " --socket path [--weights tfgo.bin] [--threads N]"
+                  << " [--workers N] [--batch N] [--wait-us N]" << std::endl;
+        return 1;
+    }
+
+    policy_net_t net;
+    std::unique_ptr<policy_net_backend_t> backend;
+    std::unique_ptr<eval_broker_t> broker;
+    if (!weights.empty()) {
+        if (!net.load(weights))
+            return 1;
+        net.set_threads(threads);
+        // genmove ranks the legal fields by logits, like tools/gtp
+        backend.reset(new policy_net_backend_t(&net, true));
+        broker.reset(new eval_broker_t(backend.get(), batch, wait_us));
+    }
+
+    gtp_server_t gtp(broker.get(), net.planes(), workers);
+    if (!gtp.listen(path))
+        return 1;
+    server = &gtp;
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+
+    std::cerr << "serving GTP sessions on " << path << std::endl;
+    gtp.run();
+    server = nullptr;
+    std::cerr << gtp.commands() << " commands";
+    if (broker)
+        std::cerr << ", mean batch size " << broker->mean_batch_size();
+    std::cerr << std::endl;
+    return 0;
+}
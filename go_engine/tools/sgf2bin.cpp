@@ -0,0 +1,152 @@
+// Convert a directory tree of ASCII SGF files into the binary SGFbin format.
+//
+//   sgf2bin <directory> [--threads N] [--pack corpus.sgfpack] [--v2] [--compress]
+//
+// Without "--pack" each "game.sgf" is written to "game.sgfbin" next to it (same as
+// "python reader.py --action convert"). With "--pack" all games are appended to a
+// single packed corpus (see docs/FILEFORMAT.md) in sorted filename order.
+// "--v2" prepends the metadata header (komi, result, ranks, ...) to each game,
+// "--compress" additionally entropy codes the moves (roughly 2-3x smaller).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/corpus.h"
+#include "../src/sgfreader.h"
+
+/**
+ * @brief convert a single game
+ * @details applies the same filters as data/reader.py (too old, not correct, amateur)
+ *
+ * @param path ASCII SGF file
+ * @param bin encoded moves
+ * @return false if the game should be skipped
+ */
+bool convert(const std::string &path, std::vector<unsigned char> *bin, bool v2, bool compress) {
+    // these collections are too old
+    if (path.find("1700-99") != std::string::npos)
+        return false;
+    if (path.find("0196-1699") != std::string::npos)
+        return false;
+
+    SGFreader game(path);
+    if (!game.valid()) {
+        std::cerr << path << " cannot be parsed" << std::endl;
+        return false;
+    }
+    if (!game.correct()) {
+        std::cerr << path << " is not correct" << std::endl;
+        return false;
+    }
+    if (game.amateur())
+        return false;
+
+    *bin = game.sgfbin(v2, compress);
+    return true;
+}
+
+void write_file(const std::string &path, const std::vector<unsigned char> &bin) {
+    std::ofstream ofs(path.c_str(), std::ios::binary | std::ios::out);
+    ofs.write((const char*) bin.data(), bin.size());
+}
+
+void write_record(std::ofstream &ofs, const std::vector<unsigned char> &bin) {
+    // record: length as uint32 (little endian) followed by the moves
+    const unsigned int len = bin.size();
+    const unsigned char header[4] = {
+        (unsigned char)(len & 0xff), (unsigned char)((len >> 8) & 0xff),
+        (unsigned char)((len >> 16) & 0xff), (unsigned char)((len >> 24) & 0xff)
+    };
+    ofs.write((const char*) header, 4);
+    ofs.write((const char*) bin.data(), bin.size());
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <directory> [--threads N] [--pack corpus.sgfpack] [--v2] [--compress]" << std::endl;
+        return 1;
+    }
+
+    std::string root = argv[1];
+    std::string pack = "";
+    bool v2 = false;
+    bool compress = false;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            num_threads = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc)
+            pack = argv[++i];
+        else if (strcmp(argv[i], "--v2") == 0)
+            v2 = true;
+        else if (strcmp(argv[i], "--compress") == 0)
+            compress = true;
+    }
+
+    std::vector<std::string> files = SGFcorpus::find_files(root, ".sgf");
+    std::cout << "found " << files.size() << " files" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::ofstream packed;
+    if (!pack.empty()) {
+        packed.open(pack.c_str(), std::ios::binary | std::ios::out);
+        if (!packed) {
+            std::cerr << "cannot write " << pack << std::endl;
+            return 1;
+        }
+    }
+
+    // files are processed in blocks, such that a packed corpus can be written in order
+    // while keeping the memory footprint bounded
+    const size_t block = 4096;
+    std::atomic<size_t> converted(0);
+
+    for (size_t first = 0; first < files.size(); first += block) {
+        const size_t last = std::min(files.size(), first + block);
+        std::vector<std::vector<unsigned char> > results(last - first);
+        std::vector<char> ok(last - first, 0);
+        std::atomic<size_t> next(first);
+
+        auto worker = [&]() {
+            for (size_t i = next++; i < last; i = next++) {
+                std::vector<unsigned char> bin;
+                if (!convert(files[i], &bin, v2, compress))
+                    continue;
+                converted++;
+                if (pack.empty()) {
+                    write_file(files[i] + "bin", bin);
+                } else {
+                    results[i - first].swap(bin);
+                    ok[i - first] = 1;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t)
+            threads.push_back(std::thread(worker));
+        for (auto &&t : threads)
+            t.join();
+
+        if (!pack.empty())
+            for (size_t i = 0; i < results.size(); ++i)
+                if (ok[i])
+                    write_record(packed, results[i]);
+    }
+
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "converted " << converted << " out of " << files.size() << " games in "
+              << secs << "s using " << num_threads << " threads" << std::endl;
+    return 0;
+}
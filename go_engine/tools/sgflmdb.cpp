@@ -0,0 +1,307 @@
+#include <sys/stat.h>
+
+#include <cstring>
+#include <iostream>
+
+#include "sgflmdb.h"
+
+namespace {
+
+/**
+ * @brief minimal msgpack reader, just enough to walk over tensorpack datapoints
+ */
+struct msgpack_t {
+    const unsigned char *pos;
+    const unsigned char *end;
+
+    bool has(size_t n) const {
+        return (size_t)(end - pos) >= n;
+    }
+
+    // big endian unsigned integer of n bytes
+    size_t uint(int n) {
+        size_t v = 0;
+        for (int i = 0; i < n; ++i)
+            v = (v << 8) | *pos++;
+        return v;
+    }
+
+    /**
+     * @brief read header of a container
+     * @return number of elements or -1 if next object is no array (map)
+     */
+    long container(bool map) {
+        if (!has(1))
+            return -1;
+        const unsigned char b = *pos;
+        const unsigned char fix = map ? 0x80 : 0x90;
+        const unsigned char c16 = map ? 0xde : 0xdc;
+        if ((b & 0xf0) == fix) {
+            pos++;
+            return b & 0x0f;
+        }
+        const int n = (b == c16) ? 2 : (b == c16 + 1) ? 4 : 0;
+        if (n == 0 || !has(1 + n))
+            return -1;
+        pos++;
+        return (long) uint(n);
+    }
+
+    /**
+     * @brief read a str or bin object
+     * @return false if next object is neither str nor bin
+     */
+    bool bytes(const unsigned char **data, size_t *len) {
+        if (!has(1))
+            return false;
+        const unsigned char b = *pos;
+        int n = -1;
+        if ((b & 0xe0) == 0xa0)
+            n = 0;
+        else if (b == 0xc4 || b == 0xd9)
+            n = 1;
+        else if (b == 0xc5 || b == 0xda)
+            n = 2;
+        else if (b == 0xc6 || b == 0xdb)
+            n = 4;
+        if (n < 0 || !has(1 + n))
+            return false;
+        pos++;
+        *len = (n == 0) ? (b & 0x1f) : uint(n);
+        if (!has(*len))
+            return false;
+        *data = pos;
+        pos += *len;
+        return true;
+    }
+
+    /**
+     * @brief skip next object (including nested containers)
+     */
+    bool skip() {
+        if (!has(1))
+            return false;
+        const unsigned char b = *pos;
+        const unsigned char *data;
+        size_t len;
+
+        if (b <= 0x7f || b >= 0xe0 || b == 0xc0 || b == 0xc2 || b == 0xc3) {
+            pos++;
+            return true;
+        }
+        if (bytes(&data, &len))
+            return true;
+        if ((b & 0xf0) == 0x80 || b == 0xde || b == 0xdf) {
+            const long n = container(true);
+            for (long i = 0; i < 2 * n; ++i)
+                if (!skip())
+                    return false;
+            return n >= 0;
+        }
+        if ((b & 0xf0) == 0x90 || b == 0xdc || b == 0xdd) {
+            const long n = container(false);
+            for (long i = 0; i < n; ++i)
+                if (!skip())
+                    return false;
+            return n >= 0;
+        }
+
+        // fixed size numbers and extension types
+        size_t n = 0;
+        switch (b) {
+            case 0xcc: case 0xd0: n = 1; break;
+            case 0xcd: case 0xd1: n = 2; break;
+            case 0xca: case 0xce: case 0xd2: n = 4; break;
+            case 0xcb: case 0xcf: case 0xd3: n = 8; break;
+            case 0xd4: n = 2; break;
+            case 0xd5: n = 3; break;
+            case 0xd6: n = 5; break;
+            case 0xd7: n = 9; break;
+            case 0xd8: n = 17; break;
+            case 0xc7: case 0xc8: case 0xc9: {
+                // [marker][length][type][data]
+                const int w = (b == 0xc7) ? 1 : (b == 0xc8) ? 2 : 4;
+                if (!has(1 + w))
+                    return false;
+                pos++;
+                n = uint(w) + 1;
+                if (!has(n))
+                    return false;
+                pos += n;
+                return true;
+            }
+            default:
+                return false;
+        }
+        if (!has(1 + n))
+            return false;
+        pos += 1 + n;
+        return true;
+    }
+};
+
+}  // namespace
+
+
+SGFlmdb::SGFlmdb(std::string path) : env_(nullptr), dbi_(0), valid_(false) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        std::cerr << "cannot read " << path << std::endl;
+        return;
+    }
+
+    // MDB_NOTLS: read transactions are bound to reader_t objects instead of threads
+    unsigned int flags = MDB_RDONLY | MDB_NOTLS | MDB_NORDAHEAD;
+    if (!S_ISDIR(st.st_mode))
+        flags |= MDB_NOSUBDIR;
+
+    int rc = mdb_env_create(&env_);
+    if (rc == 0)
+        rc = mdb_env_set_maxreaders(env_, 1024);
+    if (rc == 0)
+        rc = mdb_env_open(env_, path.c_str(), flags, 0664);
+    if (rc != 0) {
+        std::cerr << "cannot open " << path << ": " << mdb_strerror(rc) << std::endl;
+        return;
+    }
+
+    MDB_txn *txn = nullptr;
+    MDB_cursor *cursor = nullptr;
+    rc = mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn);
+    if (rc == 0)
+        rc = mdb_dbi_open(txn, nullptr, 0, &dbi_);
+    if (rc == 0)
+        rc = mdb_cursor_open(txn, dbi_, &cursor);
+    if (rc != 0) {
+        std::cerr << "cannot read " << path << ": " << mdb_strerror(rc) << std::endl;
+        if (txn != nullptr)
+            mdb_txn_abort(txn);
+        return;
+    }
+
+    // collect all keys once, tensorpack additionally stores a list of all keys in "__keys__"
+    MDB_val key, value;
+    while (mdb_cursor_get(cursor, &key, &value, MDB_NEXT) == 0) {
+        const std::string name((const char*) key.mv_data, key.mv_size);
+        if (name.compare(0, 2, "__") == 0)
+            continue;
+        keys_.push_back(name);
+    }
+    mdb_cursor_close(cursor);
+    mdb_txn_abort(txn);
+    valid_ = true;
+}
+
+SGFlmdb::~SGFlmdb() {
+    if (env_ != nullptr)
+        mdb_env_close(env_);
+}
+
+const bool SGFlmdb::valid() const {
+    return valid_;
+}
+
+const size_t SGFlmdb::size() const {
+    return keys_.size();
+}
+
+bool SGFlmdb::unpack(const unsigned char *value, size_t len,
+                     const unsigned char **buffer, int *buffer_len) {
+    msgpack_t msg = {value, value + len};
+
+    // raw SGFbin record
+    const long num_components = msg.container(false);
+    if (num_components < 0) {
+        *buffer = value;
+        *buffer_len = len;
+        return true;
+    }
+    if (num_components < 1)
+        return false;
+
+    // first component is either the bytes itself or a serialized numpy array
+    const unsigned char *data;
+    size_t data_len;
+    if (msg.bytes(&data, &data_len)) {
+        *buffer = data;
+        *buffer_len = data_len;
+        return true;
+    }
+
+    const long num_fields = msg.container(true);
+    for (long i = 0; i < num_fields; ++i) {
+        const unsigned char *name;
+        size_t name_len;
+        if (!msg.bytes(&name, &name_len))
+            return false;
+        if (name_len == 4 && memcmp(name, "data", 4) == 0)
+            if (msg.bytes(&data, &data_len)) {
+                *buffer = data;
+                *buffer_len = data_len;
+                return true;
+            }
+        if (!msg.skip())
+            return false;
+    }
+    return false;
+}
+
+
+SGFlmdb::reader_t::reader_t(const SGFlmdb &db) : db_(db), txn_(nullptr), cursor_(nullptr) {
+    if (!db_.valid_)
+        return;
+    int rc = mdb_txn_begin(db_.env_, nullptr, MDB_RDONLY, &txn_);
+    if (rc == 0)
+        rc = mdb_cursor_open(txn_, db_.dbi_, &cursor_);
+    if (rc != 0) {
+        std::cerr << "cannot start read transaction: " << mdb_strerror(rc) << std::endl;
+        if (txn_ != nullptr)
+            mdb_txn_abort(txn_);
+        txn_ = nullptr;
+        cursor_ = nullptr;
+    }
+}
+
+SGFlmdb::reader_t::~reader_t() {
+    if (cursor_ != nullptr)
+        mdb_cursor_close(cursor_);
+    if (txn_ != nullptr)
+        mdb_txn_abort(txn_);
+}
+
+bool SGFlmdb::reader_t::game(size_t i, const unsigned char **buffer, int *len) {
+    if (txn_ == nullptr || i >= db_.keys_.size())
+        return false;
+    const std::string &name = db_.keys_[i];
+    MDB_val key, value;
+    key.mv_size = name.size();
+    key.mv_data = (void*) name.data();
+    if (mdb_get(txn_, db_.dbi_, &key, &value) != 0)
+        return false;
+    return unpack((const unsigned char*) value.mv_data, value.mv_size, buffer, len);
+}
+
+bool SGFlmdb::reader_t::next(const unsigned char **buffer, int *len) {
+    if (cursor_ == nullptr)
+        return false;
+    MDB_val key, value;
+    // wrap around at the end of the database and skip special keys
+    for (size_t tries = 0; tries < db_.keys_.size() + 2; ++tries) {
+        if (mdb_cursor_get(cursor_, &key, &value, MDB_NEXT) != 0) {
+            if (mdb_cursor_get(cursor_, &key, &value, MDB_FIRST) != 0)
+                return false;
+        }
+        if (key.mv_size >= 2 && memcmp(key.mv_data, "__", 2) == 0)
+            continue;
+        return unpack((const unsigned char*) value.mv_data, value.mv_size, buffer, len);
+    }
+    return false;
+}
+
+void SGFlmdb::reader_t::refresh() {
+    if (txn_ == nullptr)
+        return;
+    mdb_txn_reset(txn_);
+    if (mdb_txn_renew(txn_) != 0 || mdb_cursor_renew(txn_, cursor_) != 0)
+        std::cerr << "cannot renew read transaction" << std::endl;
+}
@@ -0,0 +1,100 @@
+#ifndef ENGINE_SGFLMDB_H
+#define ENGINE_SGFLMDB_H
+
+#include <lmdb.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Read-only access to games stored in a LMDB database (go_db.py --action create)
+ * @details Each record is a datapoint serialized by tensorpack, i.e. a msgpack array holding
+ *          a single numpy array with the raw SGFbin bytes. Records are located in the memory
+ *          map of LMDB and handed out without any copy (see SGFbin(const unsigned char*, int, bool)).
+ *
+ *          The environment is opened with MDB_NOTLS, such that every thread can keep its own
+ *          read-only transaction (one reader_t per thread). Pointers returned by a reader stay
+ *          valid until its transaction is refreshed or the reader is destroyed.
+ */
+class SGFlmdb {
+  public:
+    /**
+     * @brief open database and collect all keys of games
+     *
+     * @param path path to *.lmdb file (or directory containing data.mdb)
+     */
+    SGFlmdb(std::string path);
+    ~SGFlmdb();
+
+    /**
+     * @brief could the database be opened?
+     */
+    const bool valid() const;
+
+    /**
+     * @brief number of games
+     */
+    const size_t size() const;
+
+    /**
+     * @brief locate the SGFbin bytes inside a serialized datapoint
+     * @details Records which are no msgpack array are assumed to contain SGFbin bytes directly.
+     *
+     * @param value record as stored in LMDB
+     * @param len length of record
+     * @param buffer start of SGFbin bytes within value
+     * @param buffer_len length of SGFbin bytes
+     * @return false if the record cannot be parsed
+     */
+    static bool unpack(const unsigned char *value, size_t len, const unsigned char **buffer, int *buffer_len);
+
+    /**
+     * @brief Read-only transaction of a single thread
+     */
+    class reader_t {
+      public:
+        reader_t(const SGFlmdb &db);
+        ~reader_t();
+
+        /**
+         * @brief raw SGFbin bytes of game i (random access)
+         *
+         * @param i index of game
+         * @param buffer points into the memory map of LMDB
+         * @param len length of buffer
+         * @return false if the game cannot be read
+         */
+        bool game(size_t i, const unsigned char **buffer, int *len);
+
+        /**
+         * @brief raw SGFbin bytes of the next game in key order (restarts at the first game)
+         */
+        bool next(const unsigned char **buffer, int *len);
+
+        /**
+         * @brief release the snapshot and start a new one (invalidates all returned buffers)
+         * @details Long-living read transactions keep LMDB from reusing pages of a database
+         *          which is written concurrently.
+         */
+        void refresh();
+
+      private:
+        reader_t(const reader_t&);
+        reader_t& operator=(const reader_t&);
+
+        const SGFlmdb &db_;
+        MDB_txn *txn_;
+        MDB_cursor *cursor_;
+    };
+
+  private:
+    SGFlmdb(const SGFlmdb&);
+    SGFlmdb& operator=(const SGFlmdb&);
+
+    MDB_env *env_;
+    MDB_dbi dbi_;
+    bool valid_;
+    std::vector<std::string> keys_;
+};
+
+#endif
@@ -0,0 +1,91 @@
+// List all SGFbin (version 2) games of a directory tree which pass a filter. Only the
+// fixed size header of each file is read.
+//
+//   sgfscan <directory> [--min-rank 7d] [--pro] [--max-handicap N] [--result B|W|any]
+//                       [--scored] [--from YEAR] [--to YEAR]
+//
+// Each matching game is printed as "<path> <winner> <komi>", which can directly be used
+// as outcome label for value-net training sets.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/corpus.h"
+#include "../src/sgfbin.h"
+
+struct filter_t {
+    int min_rank = 0;
+    int max_handicap = 9;
+    int winner = 0;
+    bool scored = false;
+    int from = 0;
+    int to = 9999;
+
+    bool accept(const sgfbin_header_t &h) const {
+        if (std::min(h.rank_black, h.rank_white) < min_rank)
+            return false;
+        if (h.handicap > max_handicap)
+            return false;
+        if (winner != 0 && h.winner != winner)
+            return false;
+        if (scored && !(h.flags & sgfbin_header_t::has_result && h.result == sgfbin_header_t::by_score))
+            return false;
+        if (h.year < from || h.year > to)
+            return false;
+        return true;
+    }
+};
+
+void scan(const std::string &path, const filter_t &filter, int *total, int *matched) {
+    unsigned char raw[sgfbin_header_t::length];
+    std::ifstream ifs(path.c_str(), std::ios::binary | std::ios::in);
+    ifs.read((char*) raw, sgfbin_header_t::length);
+
+    sgfbin_header_t h;
+    (*total)++;
+    if (!h.decode(raw, ifs.gcount()))
+        return;
+    if (!filter.accept(h))
+        return;
+    (*matched)++;
+    const char *winner[] = {"?", "B", "W", "0"};
+    std::cout << path << " " << winner[h.winner & 3] << " " << (h.komi / 2.f) << std::endl;
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <directory> [--min-rank 7d] [--pro] [--max-handicap N]"
+                  << " [--result B|W|any] [--scored] [--from YEAR] [--to YEAR]" << std::endl;
+        return 1;
+    }
+
+    filter_t filter;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--min-rank") == 0 && i + 1 < argc)
+            filter.min_rank = sgfbin_header_t::parse_rank(argv[++i]);
+        else if (strcmp(argv[i], "--pro") == 0)
+            filter.min_rank = sgfbin_header_t::rank_pro + 1;
+        else if (strcmp(argv[i], "--max-handicap") == 0 && i + 1 < argc)
+            filter.max_handicap = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--result") == 0 && i + 1 < argc) {
+            const char c = argv[++i][0];
+            filter.winner = (c == 'B' || c == 'b') ? 1 : (c == 'W' || c == 'w') ? 2 : 0;
+        } else if (strcmp(argv[i], "--scored") == 0)
+            filter.scored = true;
+        else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc)
+            filter.from = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc)
+            filter.to = atoi(argv[++i]);
+    }
+
+    int total = 0, matched = 0;
+    for (auto &&path : SGFcorpus::find_files(argv[1], ".sgfbin"))
+        scan(path, filter, &total, &matched);
+    std::cerr << matched << " out of " << total << " games match" << std::endl;
+    return 0;
+}